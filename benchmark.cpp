@@ -1,9 +1,23 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <optional>
 
 #include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+#include "tt_metal/impl/allocator/algorithms/allocator_handle.hpp"
 #include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
 #include "tt_metal/impl/allocator/algorithms/free_list.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt_simd.hpp"
+#include "tt_metal/impl/allocator/algorithms/host_memory_resource.hpp"
+#include "perf_counters.hpp"
+
+#include <random>
+#include <sstream>
+#include <tuple>
 namespace bm = benchmark;
 
 // UDL to convert integer literals to SI units
@@ -11,6 +25,40 @@ constexpr size_t operator"" _KiB(unsigned long long x) { return x * 1024; }
 constexpr size_t operator"" _MiB(unsigned long long x) { return x * 1024 * 1024; }
 constexpr size_t operator"" _GiB(unsigned long long x) { return x * 1024 * 1024 * 1024; }
 
+// Set by --perf_counters. Reports hardware counters per iteration as user counters (plus IPC). They cover the whole
+// benchmark function, including work done with the timer paused
+bool perf_counters_enabled = false;
+
+template <typename Func>
+void WithPerfCounters(bm::State& state, Func&& func) {
+    if(!perf_counters_enabled) {
+        func();
+        return;
+    }
+    PerfCounters counters;
+    if(!counters.available()) {
+        static bool warned = false;
+        if(!warned) {
+            std::cerr << "perf_event_open failed, running without hardware counters "
+                      << "(check /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+            warned = true;
+        }
+        func();
+        return;
+    }
+    counters.start();
+    func();
+    double cycles = 0, instructions = 0;
+    for(const auto& [name, value] : counters.stop()) {
+        state.counters[name] = bm::Counter(value, bm::Counter::kAvgIterations);
+        cycles = name == "cycles" ? value : cycles;
+        instructions = name == "instructions" ? value : instructions;
+    }
+    if(cycles != 0 && instructions != 0) {
+        state.counters["IPC"] = instructions / cycles;
+    }
+}
+
 void bench_typical(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
     std::vector<size_t> allocation_sizes = {64_KiB, 64_KiB, 120_KiB, 60_MiB, 256_KiB, 12_KiB, 16_MiB, 1_KiB};
     std::vector<size_t> temp_allocations = {16_KiB, 16_KiB, 16_KiB, 16_MiB, 32_KiB, 1_KiB, 1_MiB, 3_KiB};
@@ -36,6 +84,78 @@ void bench_typical(tt::tt_metal::allocator::Algorithm& allocator, bm::State& sta
     }
 }
 
+// bench_typical with the buffers charged to two tenants, alternating, with quotas that are never hit
+void bench_typical_tenants(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    std::vector<size_t> allocation_sizes = {64_KiB, 64_KiB, 120_KiB, 60_MiB, 256_KiB, 12_KiB, 16_MiB, 1_KiB};
+    std::vector<size_t> temp_allocations = {16_KiB, 16_KiB, 16_KiB, 16_MiB, 32_KiB, 1_KiB, 1_MiB, 3_KiB};
+    std::vector<std::optional<DeviceAddr>> allocations(allocation_sizes.size());
+    std::vector<std::optional<DeviceAddr>> temp_allocs(temp_allocations.size());
+    auto tenants = {allocator.add_tenant("model_a", 11_GiB), allocator.add_tenant("model_b", 11_GiB)};
+    size_t n_runs = 100;
+    for (auto _ : state) {
+        state.PauseTiming();
+        allocator.clear();
+        state.ResumeTiming();
+
+        for(size_t i = 0; i < n_runs; i++) {
+            auto tenant = tenants.begin()[i % 2];
+            for(size_t j = 0; j < allocation_sizes.size(); j++) {
+                allocations[j] = allocator.allocate_for_tenant(tenant, allocation_sizes[j]);
+                temp_allocs[j] = allocator.allocate_for_tenant(tenant, temp_allocations[j]);
+            }
+
+            for(size_t j = 0; j < allocation_sizes.size(); j++) {
+                allocator.deallocate(temp_allocs[j].value());
+            }
+        }
+    }
+}
+
+// bench_typical's size mix on host memory through a std::pmr::memory_resource. What is still live is freed between
+// iterations, outside of the timing
+void bench_typical_host(std::pmr::memory_resource& resource, bm::State& state) {
+    std::vector<size_t> allocation_sizes = {64_KiB, 64_KiB, 120_KiB, 60_MiB, 256_KiB, 12_KiB, 16_MiB, 1_KiB};
+    std::vector<size_t> temp_allocations = {16_KiB, 16_KiB, 16_KiB, 16_MiB, 32_KiB, 1_KiB, 1_MiB, 3_KiB};
+    std::vector<std::pair<void*, size_t>> allocations;
+    std::vector<void*> temp_allocs(temp_allocations.size());
+    size_t n_runs = 100;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for(const auto& [p, size] : allocations) {
+            resource.deallocate(p, size);
+        }
+        allocations.clear();
+        state.ResumeTiming();
+
+        for(size_t i = 0; i < n_runs; i++) {
+            for(size_t j = 0; j < allocation_sizes.size(); j++) {
+                allocations.emplace_back(resource.allocate(allocation_sizes[j]), allocation_sizes[j]);
+                temp_allocs[j] = resource.allocate(temp_allocations[j]);
+            }
+
+            for(size_t j = 0; j < temp_allocations.size(); j++) {
+                resource.deallocate(temp_allocs[j], temp_allocations[j]);
+            }
+        }
+    }
+    for(const auto& [p, size] : allocations) {
+        resource.deallocate(p, size);
+    }
+}
+
+// Plain malloc/free as a memory resource, the baseline for host allocations
+class MallocResource : public std::pmr::memory_resource {
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = alignment <= alignof(std::max_align_t) ? std::malloc(bytes) : std::aligned_alloc(alignment, bytes);
+        if(p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+    void do_deallocate(void* p, size_t /*bytes*/, size_t /*alignment*/) override { std::free(p); }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
 void bench_mixed(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
     std::vector<size_t> allocation_sizes = {64_KiB, 64_KiB, 120_KiB, 60_MiB, 256_KiB, 12_KiB, 16_MiB, 1_KiB};
     std::vector<size_t> temp_allocations = {16_KiB, 16_KiB, 16_KiB, 16_MiB, 32_KiB, 1_KiB, 1_MiB, 3_KiB};
@@ -64,7 +184,9 @@ void bench_mixed(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state
     }
 }
 
-void bench_worst(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
+// Templated so that they can also run on the concrete allocators and AllocatorHandle to compare dispatch
+template <typename Allocator>
+void bench_worst(Allocator& allocator, bm::State& state) {
     size_t n_runs = 1000;
     for (auto _ : state) {
         state.PauseTiming();
@@ -82,7 +204,8 @@ void bench_worst(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state
     }
 }
 
-void bench_small(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
+template <typename Allocator>
+void bench_small(Allocator& allocator, bm::State& state) {
     size_t n_runs = 20;
     for (auto _ : state) {
         state.PauseTiming();
@@ -105,7 +228,7 @@ void bench_small(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state
     }
 }
 
-void bench_get_available_addresses(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
+void fragment_for_available_addresses(tt::tt_metal::allocator::Algorithm& allocator) {
     std::vector<std::optional<DeviceAddr>> allocations(450);
     for(size_t i = 0; i < allocations.size(); i++) {
         allocations[i] = allocator.allocate(1_KiB);
@@ -113,11 +236,34 @@ void bench_get_available_addresses(tt::tt_metal::allocator::Algorithm& allocator
     for(size_t i = 0; i < allocations.size(); i+=2) {
         allocator.deallocate(allocations[i].value());
     }
+}
+
+void bench_get_available_addresses(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
+    fragment_for_available_addresses(allocator);
     for (auto _ : state) {
         bm::DoNotOptimize(allocator.available_addresses(1_KiB));
     }
 }
 
+// Same heap through the allocation free overloads. Every range into a reused buffer, and only the lowest one
+void bench_get_available_addresses_into(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    fragment_for_available_addresses(allocator);
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> buffer(1024);
+    for (auto _ : state) {
+        bm::DoNotOptimize(allocator.available_addresses(1_KiB, buffer.data(), buffer.size()));
+        bm::ClobberMemory();
+    }
+}
+
+void bench_get_available_addresses_first(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    fragment_for_available_addresses(allocator);
+    std::pair<DeviceAddr, DeviceAddr> first;
+    for (auto _ : state) {
+        bm::DoNotOptimize(allocator.available_addresses(1_KiB, &first, 1));
+        bm::ClobberMemory();
+    }
+}
+
 void bench_statistics(tt::tt_metal::allocator::Algorithm& allocator, bm::State& state) {
     std::vector<std::optional<DeviceAddr>> allocations(450);
     for(size_t i = 0; i < allocations.size(); i++) {
@@ -141,11 +287,276 @@ void bench_shrink_reset(tt::tt_metal::allocator::Algorithm& allocator, bm::State
     }
 }
 
+// Commit a precomputed layout of 5000 buffers with gaps between them, one request at a time vs in bulk
+std::vector<std::pair<DeviceAddr, DeviceAddr>> make_plan_layout() {
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> layout;
+    DeviceAddr addr = 0;
+    for(size_t i = 0; i < 5000; i++) {
+        DeviceAddr size = (i % 7 + 1) * 1_KiB;
+        layout.push_back({addr, size});
+        addr += size + (i % 3) * 1_KiB;
+    }
+    return layout;
+}
+
+void bench_load_plan(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    auto layout = make_plan_layout();
+    for (auto _ : state) {
+        state.PauseTiming();
+        allocator.clear();
+        state.ResumeTiming();
+
+        for(const auto& [addr, size] : layout) {
+            bm::DoNotOptimize(allocator.allocate_at_address(addr, size));
+        }
+    }
+}
+
+void bench_load_plan_bulk(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    auto layout = make_plan_layout();
+    for (auto _ : state) {
+        state.PauseTiming();
+        allocator.clear();
+        state.ResumeTiming();
+
+        bm::DoNotOptimize(allocator.allocate_at_addresses(layout));
+    }
+}
+
+// Dump a heap fragmented into 10k blocks
+template <tt::tt_metal::allocator::FreeListOpt::DumpFormat Format>
+void bench_dump(tt::tt_metal::allocator::FreeListOpt& allocator, bm::State& state) {
+    std::vector<DeviceAddr> allocations;
+    for(size_t i = 0; i < 10000; i++) {
+        allocations.push_back(allocator.allocate(64_KiB + (i % 7) * 1_KiB).value());
+    }
+    for(size_t i = 0; i < allocations.size(); i += 2) {
+        allocator.deallocate(allocations[i]);
+    }
+    std::stringstream out;
+    for (auto _ : state) {
+        out.str("");
+        allocator.dump_blocks(out, Format);
+        bm::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(state.iterations() * out.str().size());
+}
+
+// Scaling benchmarks. The heap holds state.range(0) live blocks of the minimum size with a hole of the same size after
+// each, so nothing coalesces and the allocator has as many free blocks as allocated ones. Mutating operations are timed
+// in batches of scaling_batch and undone with the timer paused, so every iteration sees the same heap
+constexpr size_t scaling_batch = 64;
+
+struct ScalingHeap {
+    DeviceAddr block_size;
+    std::vector<DeviceAddr> holes;  // Start of every hole
+};
+
+ScalingHeap make_scaling_heap(tt::tt_metal::allocator::Algorithm& allocator, size_t n_blocks, DeviceAddr block_size) {
+    ScalingHeap heap{.block_size = block_size, .holes = {}};
+    heap.holes.reserve(n_blocks);
+    for(size_t i = 0; i < n_blocks; i++) {
+        heap.holes.push_back(allocator.allocate(block_size).value());
+        allocator.allocate(block_size).value();
+    }
+    for(auto addr : heap.holes) {
+        allocator.deallocate(addr);
+    }
+    return heap;
+}
+
+void scaling_allocate(tt::tt_metal::allocator::Algorithm& allocator, const ScalingHeap& heap, bm::State& state) {
+    std::vector<DeviceAddr> allocations(scaling_batch);
+    for (auto _ : state) {
+        for(auto& addr : allocations) {
+            addr = allocator.allocate(heap.block_size).value();
+        }
+        state.PauseTiming();
+        for(auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * scaling_batch);
+}
+
+void scaling_deallocate(tt::tt_metal::allocator::Algorithm& allocator, const ScalingHeap& heap, bm::State& state) {
+    std::vector<DeviceAddr> allocations(scaling_batch);
+    for (auto _ : state) {
+        state.PauseTiming();
+        for(auto& addr : allocations) {
+            addr = allocator.allocate(heap.block_size).value();
+        }
+        state.ResumeTiming();
+        for(auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * scaling_batch);
+}
+
+void scaling_allocate_at_address(tt::tt_metal::allocator::Algorithm& allocator, const ScalingHeap& heap, bm::State& state) {
+    // Holes spread over the whole heap
+    std::vector<DeviceAddr> addresses;
+    for(size_t i = 0; i < std::min(scaling_batch, heap.holes.size()); i++) {
+        addresses.push_back(heap.holes[i * heap.holes.size() / std::min(scaling_batch, heap.holes.size())]);
+    }
+    for (auto _ : state) {
+        for(auto addr : addresses) {
+            bm::DoNotOptimize(allocator.allocate_at_address(addr, heap.block_size));
+        }
+        state.PauseTiming();
+        for(auto addr : addresses) {
+            allocator.deallocate(addr);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * addresses.size());
+}
+
+void scaling_statistics(tt::tt_metal::allocator::Algorithm& allocator, const ScalingHeap& /*heap*/, bm::State& state) {
+    for (auto _ : state) {
+        bm::DoNotOptimize(allocator.get_statistics());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void scaling_available_addresses(tt::tt_metal::allocator::Algorithm& allocator, const ScalingHeap& heap, bm::State& state) {
+    for (auto _ : state) {
+        bm::DoNotOptimize(allocator.available_addresses(heap.block_size));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// state.range(0) L1 sized banks, each with 1000 1 KiB buffers of which a different random half was freed. The only
+// 1 KiB range free in all of them is above the buffers, so the search has to go through every bank's free ranges
+std::vector<std::unique_ptr<tt::tt_metal::allocator::FreeListOpt>> make_interleaved_banks(size_t n_banks) {
+    std::vector<std::unique_ptr<tt::tt_metal::allocator::FreeListOpt>> banks;
+    for(size_t bank = 0; bank < n_banks; bank++) {
+        banks.push_back(std::make_unique<tt::tt_metal::allocator::FreeListOpt>(1536_KiB, 0, 32, 32));
+        std::mt19937 gen(bank);
+        std::vector<DeviceAddr> allocations;
+        for(size_t i = 0; i < 1000; i++) {
+            allocations.push_back(banks.back()->allocate(1_KiB).value());
+        }
+        for(DeviceAddr address : allocations) {
+            if(gen() % 2 == 0) {
+                banks.back()->deallocate(address);
+            }
+        }
+    }
+    return banks;
+}
+
+void bench_common_free_address(bm::State& state) {
+    auto banks = make_interleaved_banks(state.range(0));
+    std::vector<const tt::tt_metal::allocator::FreeListOpt*> bank_ptrs;
+    for(const auto& bank : banks) {
+        bank_ptrs.push_back(bank.get());
+    }
+    WithPerfCounters(state, [&] {
+        for (auto _ : state) {
+            bm::DoNotOptimize(tt::tt_metal::allocator::FreeListOpt::find_common_free_address(bank_ptrs, 1_KiB));
+        }
+    });
+}
+
+// Same search by intersecting every bank's available_addresses one after the other
+void bench_common_free_address_by_intersection(bm::State& state) {
+    auto banks = make_interleaved_banks(state.range(0));
+    WithPerfCounters(state, [&] {
+        for (auto _ : state) {
+            auto common = banks[0]->available_addresses(1_KiB);
+            std::sort(common.begin(), common.end());
+            for(size_t bank = 1; bank < banks.size(); bank++) {
+                auto ranges = banks[bank]->available_addresses(1_KiB);
+                std::sort(ranges.begin(), ranges.end());
+                std::vector<std::pair<DeviceAddr, DeviceAddr>> intersection;
+                for(size_t i = 0, j = 0; i < common.size() && j < ranges.size();) {
+                    DeviceAddr start = std::max(common[i].first, ranges[j].first);
+                    DeviceAddr end = std::min(common[i].second, ranges[j].second);
+                    if(end > start && end - start >= 1_KiB) {
+                        intersection.emplace_back(start, end);
+                    }
+                    (common[i].second < ranges[j].second ? i : j)++;
+                }
+                common = std::move(intersection);
+            }
+            bm::DoNotOptimize(common);
+        }
+    });
+}
+
+// Warm start of a 1 GiB bank holding state.range(0) persistent buffers (firmware, kernel binaries, pinned weights)
+std::vector<std::pair<DeviceAddr, DeviceAddr>> make_persistent_buffers(size_t n_buffers) {
+    std::mt19937 gen(42);
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> buffers;
+    DeviceAddr address = 0;
+    for(size_t i = 0; i < n_buffers; i++) {
+        address += (gen() % 4) * 1_KiB;
+        DeviceAddr size = (gen() % 32 + 1) * 1_KiB;
+        buffers.emplace_back(address, size);
+        address += size;
+    }
+    return buffers;
+}
+
+// Replaying allocate_at_address for every buffer, what a process start does today
+void bench_warm_start_replay(bm::State& state) {
+    auto buffers = make_persistent_buffers(state.range(0));
+    WithPerfCounters(state, [&] {
+        for (auto _ : state) {
+            tt::tt_metal::allocator::FreeListOpt allocator(1_GiB, 0, 32, 32);
+            for(const auto& [address, size] : buffers) {
+                allocator.allocate_at_address(address, size);
+            }
+            bm::DoNotOptimize(allocator);
+        }
+    });
+}
+
+// Loading the blob serialize() saved after the same replay
+void bench_warm_start_deserialize(bm::State& state) {
+    auto buffers = make_persistent_buffers(state.range(0));
+    tt::tt_metal::allocator::FreeListOpt saved(1_GiB, 0, 32, 32);
+    for(const auto& [address, size] : buffers) {
+        saved.allocate_at_address(address, size);
+    }
+    auto blob = saved.serialize();
+    WithPerfCounters(state, [&] {
+        for (auto _ : state) {
+            tt::tt_metal::allocator::FreeListOpt allocator(1_GiB, 0, 32, 32);
+            allocator.deserialize(blob.data(), blob.size());
+            bm::DoNotOptimize(allocator);
+        }
+    });
+    state.counters["blob_bytes"] = blob.size();
+}
+
+// Best fit scan over one size class holding state.range(0) blocks, none of which is an exact fit
+template <auto FindBestFit>
+void bench_best_fit_scan(bm::State& state) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> size_dist(16, 31);
+    std::vector<DeviceAddr> sizes(state.range(0));
+    for(auto& size : sizes) {
+        size = size_dist(gen) * 64_KiB;
+    }
+    DeviceAddr alloc_size = 24 * 64_KiB + 1;
+    WithPerfCounters(state, [&] {
+        for (auto _ : state) {
+            bm::DoNotOptimize(FindBestFit(sizes.data(), sizes.size(), alloc_size, true));
+        }
+    });
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+
 template <typename Allocator, typename BenchFunc, typename ... Args>
 void RegisterBenchmark(const std::string& name, BenchFunc func, Args&& ... args) {
     auto benchmark_func = [=](bm::State& state) {
         Allocator allocator(args...);
-        func(allocator, state);
+        WithPerfCounters(state, [&] { func(allocator, state); });
+        state.counters["host_bytes"] = allocator.metadata_memory_bytes();
     };
     bm::RegisterBenchmark(name.c_str(), benchmark_func);
 }
@@ -158,10 +569,10 @@ void RegisterBenchmarksForAllocator(const std::string& allocator_name, Args&& ..
     size_t max_alloc_size = 64;
 
     std::vector<std::pair<std::string, std::function<void(tt::tt_metal::allocator::Algorithm&, bm::State&)>>> benchmarks = {
-        {"WorstCase", bench_worst},
+        {"WorstCase", bench_worst<tt::tt_metal::allocator::Algorithm>},
         {"MixedAllocations", bench_mixed},
         {"TypicalCase", bench_typical},
-        {"Small", bench_small},
+        {"Small", bench_small<tt::tt_metal::allocator::Algorithm>},
         {"GetAvailableAddresses", bench_get_available_addresses},
         {"Statistics", bench_statistics},
         {"ShrinkReset", bench_shrink_reset}
@@ -172,13 +583,142 @@ void RegisterBenchmarksForAllocator(const std::string& allocator_name, Args&& ..
     }
 }
 
+// One family per allocator, operation, heap size and alignment, ranging over the live block count from 10 to 1M (as
+// far as the heap allows) with the complexity fitted over the range
+template <typename Allocator, typename ... Args>
+void RegisterScalingBenchmarks(const std::string& allocator_name, Args&& ... args) {
+    std::vector<std::pair<std::string, size_t>> heaps = {{"1.5MiB", 1536_KiB}, {"12GiB", 12_GiB}};
+    std::vector<std::pair<std::string, size_t>> alignments = {{"32B", 32}, {"1KiB", 1_KiB}};
+    std::vector<std::pair<std::string, void (*)(tt::tt_metal::allocator::Algorithm&, const ScalingHeap&, bm::State&)>> operations = {
+        {"Allocate", scaling_allocate},
+        {"Deallocate", scaling_deallocate},
+        {"AllocateAtAddress", scaling_allocate_at_address},
+        {"Statistics", scaling_statistics},
+        {"GetAvailableAddresses", scaling_available_addresses}
+    };
+
+    for(const auto& [heap_name, heap_size] : heaps) {
+        for(const auto& [alignment_name, alignment] : alignments) {
+            for(const auto& [operation_name, operation] : operations) {
+                std::string name = "Scaling/" + allocator_name + "/" + operation_name + "/" + heap_name + "/" + alignment_name;
+                auto benchmark_func = [=](bm::State& state) {
+                    Allocator allocator(heap_size, 0, alignment, alignment, args...);
+                    auto heap = make_scaling_heap(allocator, state.range(0), alignment);
+                    WithPerfCounters(state, [&] { operation(allocator, heap, state); });
+                    state.SetComplexityN(state.range(0));
+                };
+                auto* benchmark = bm::RegisterBenchmark(name.c_str(), benchmark_func);
+                // Keep at least half of the heap free
+                for(size_t n_blocks = 10; n_blocks <= 1000000 && n_blocks * 4 * alignment <= heap_size; n_blocks *= 10) {
+                    benchmark->Arg(n_blocks);
+                }
+                benchmark->Complexity();
+            }
+        }
+    }
+}
+
+// The same workload called through Algorithm's vtable, on the concrete (final) class and through AllocatorHandle
+template <typename Allocator, typename ... Args>
+void RegisterDispatchBenchmarks(const std::string& allocator_name, Args&& ... args) {
+    using tt::tt_metal::allocator::Algorithm;
+    using tt::tt_metal::allocator::AllocatorHandle;
+    std::vector<std::tuple<std::string, void (*)(Algorithm&, bm::State&), void (*)(Allocator&, bm::State&), void (*)(AllocatorHandle&, bm::State&)>> benchmarks = {
+        {"WorstCase", bench_worst<Algorithm>, bench_worst<Allocator>, bench_worst<AllocatorHandle>},
+        {"Small", bench_small<Algorithm>, bench_small<Allocator>, bench_small<AllocatorHandle>}
+    };
+    for(const auto& [name, virtual_func, static_func, handle_func] : benchmarks) {
+        std::string prefix = "Dispatch/" + allocator_name + "/" + name;
+        auto virtual_benchmark = [=](Allocator& allocator, bm::State& state) {
+            // Through a pointer the optimizer can't see through, as a caller holding only an Algorithm would
+            Algorithm* algorithm = &allocator;
+            bm::DoNotOptimize(algorithm);
+            virtual_func(*algorithm, state);
+        };
+        RegisterBenchmark<Allocator>(prefix + "/Virtual", virtual_benchmark, 12_GiB, 0, 64, 64, args...);
+        RegisterBenchmark<Allocator>(prefix + "/Static", static_func, 12_GiB, 0, 64, 64, args...);
+        RegisterBenchmark<AllocatorHandle>(prefix + "/Handle", handle_func, std::in_place_type<Allocator>, 12_GiB, 0, 64, 64, args...);
+    }
+}
+
 void RegisterAllBenchmarks() {
     RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt");
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[Compact]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.metadata_layout = tt::tt_metal::allocator::FreeListOpt::MetadataLayout::COMPACT});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[SizeOrdered]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.size_class_order = tt::tt_metal::allocator::FreeListOpt::SizeClassOrder::SIZE});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[Subdivided]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.size_class_base = 64, .size_class_subdivisions = 4});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[QuickList]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.quick_list_depth = 8});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[FirstFit]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.search_policy = tt::tt_metal::allocator::FreeListOpt::SearchPolicy::FIRST});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[NextFit]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.search_policy = tt::tt_metal::allocator::FreeListOpt::SearchPolicy::NEXT});
+    RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt[GoodEnoughFit]",
+        tt::tt_metal::allocator::FreeListOpt::Options{.search_policy = tt::tt_metal::allocator::FreeListOpt::SearchPolicy::GOOD_ENOUGH});
     RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeList>("FreeList[BestMatch]", tt::tt_metal::allocator::FreeList::SearchPolicy::BEST);
     RegisterBenchmarksForAllocator<tt::tt_metal::allocator::FreeList>("FreeList[FirstMatch]", tt::tt_metal::allocator::FreeList::SearchPolicy::FIRST);
+
+    // FreeListOpt only APIs
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/LoadPlan", bench_load_plan, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/LoadPlanBulk", bench_load_plan_bulk, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/TypicalCaseTenants", bench_typical_tenants, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/GetAvailableAddressesInto", bench_get_available_addresses_into, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/GetAvailableAddressesFirst", bench_get_available_addresses_first, 12_GiB, 0, 64, 64);
+    // Allocation size rounding with the specialized (16 and 32 B), other power of two (64 B) and other (96 B) alignments
+    for(size_t alignment : {16, 32, 64, 96}) {
+        RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/WorstCase/Alignment:" + std::to_string(alignment), bench_worst<tt::tt_metal::allocator::FreeListOpt>, 12_GiB, 0, alignment, alignment);
+    }
+    using DumpFormat = tt::tt_metal::allocator::FreeListOpt::DumpFormat;
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/DumpText", bench_dump<DumpFormat::TEXT>, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/DumpJSON", bench_dump<DumpFormat::JSON>, 12_GiB, 0, 64, 64);
+    RegisterBenchmark<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt/DumpBinary", bench_dump<DumpFormat::BINARY>, 12_GiB, 0, 64, 64);
+
+    bm::RegisterBenchmark("CommonFreeAddress/Sweep", bench_common_free_address)->Arg(8)->Arg(64)->Arg(128)->Arg(256);
+    bm::RegisterBenchmark("CommonFreeAddress/Intersection", bench_common_free_address_by_intersection)->Arg(8)->Arg(64)->Arg(128)->Arg(256);
+
+    // The typical size mix on host memory. Live buffers peak at 7.5 GiB, mapped but never touched
+    bm::RegisterBenchmark("HostTypicalCase/FreeListOpt", [](bm::State& state) {
+        tt::tt_metal::allocator::HostMemoryResource resource(12_GiB);
+        WithPerfCounters(state, [&] { bench_typical_host(resource, state); });
+        state.counters["host_bytes"] = resource.allocator().metadata_memory_bytes();
+    });
+    bm::RegisterBenchmark("HostTypicalCase/UnsynchronizedPool", [](bm::State& state) {
+        std::pmr::unsynchronized_pool_resource resource;
+        WithPerfCounters(state, [&] { bench_typical_host(resource, state); });
+    });
+    bm::RegisterBenchmark("HostTypicalCase/Malloc", [](bm::State& state) {
+        MallocResource resource;
+        WithPerfCounters(state, [&] { bench_typical_host(resource, state); });
+    });
+
+    bm::RegisterBenchmark("WarmStart/Replay", bench_warm_start_replay)->Arg(100)->Arg(1000)->Arg(10000);
+    bm::RegisterBenchmark("WarmStart/Deserialize", bench_warm_start_deserialize)->Arg(100)->Arg(1000)->Arg(10000);
+
+    RegisterDispatchBenchmarks<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt");
+    RegisterDispatchBenchmarks<tt::tt_metal::allocator::FreeList>("FreeList[BestMatch]", tt::tt_metal::allocator::FreeList::SearchPolicy::BEST);
+
+    RegisterScalingBenchmarks<tt::tt_metal::allocator::FreeListOpt>("FreeListOpt");
+    RegisterScalingBenchmarks<tt::tt_metal::allocator::FreeList>("FreeList[BestMatch]", tt::tt_metal::allocator::FreeList::SearchPolicy::BEST);
+
+    namespace simd = tt::tt_metal::allocator::simd;
+    bm::RegisterBenchmark("BestFitScan/Scalar", bench_best_fit_scan<simd::find_best_fit_scalar>)->RangeMultiplier(10)->Range(100, 10000);
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+        bm::RegisterBenchmark("BestFitScan/AVX2", bench_best_fit_scan<simd::find_best_fit_avx2>)->RangeMultiplier(10)->Range(100, 10000);
+    }
+    if (simd::cpu_has_avx512()) {
+        bm::RegisterBenchmark("BestFitScan/AVX512", bench_best_fit_scan<simd::find_best_fit_avx512>)->RangeMultiplier(10)->Range(100, 10000);
+    }
+#endif
 }
 
+// Extra flag: --perf_counters
 int main(int argc, char** argv) {
+    auto is_perf_counters_flag = [](const char* arg) { return std::string(arg) == "--perf_counters"; };
+    perf_counters_enabled = std::any_of(argv + 1, argv + argc, is_perf_counters_flag);
+    argc = std::remove_if(argv + 1, argv + argc, is_perf_counters_flag) - argv;
     bm::Initialize(&argc, argv);
     RegisterAllBenchmarks();
     bm::RunSpecifiedBenchmarks();
@@ -2,47 +2,378 @@
 #include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
 #include "tt_metal/impl/allocator/algorithms/free_list.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <random>
+#include <sstream>
+#include <string>
 
-size_t test_allocator(tt::tt_metal::allocator::Algorithm& allocator, size_t alloc_size, size_t seed = 42)
+// Fragmentation suite. Runs allocation workloads against every allocator until the first allocation fails, over many
+// seeds, and reports how full and how fragmented the bank was at that point:
+// - attempts: allocation attempts until the first failure
+// - utilization: allocated bytes / bank size
+// - external fragmentation: 1 - largest free block / free bytes
+// - free blocks: number of free blocks
+// Usage: tt-alloc-fragmentation [--format text|csv|json] [--seeds N] [--series N] [--bank-size B] [--alignment B]
+//                               [--trace histogram_file]...
+// --series N also samples the metrics every N attempts (csv and json only). --trace adds workloads drawing sizes from a
+// recorded size histogram, in the format tt-alloc-size-classes reads
+
+using tt::tt_metal::allocator::Algorithm;
+using tt::tt_metal::allocator::FreeList;
+using tt::tt_metal::allocator::FreeListOpt;
+
+// Give up on workloads that never fill the bank
+constexpr size_t max_attempts = 1000000;
+
+using SizeDistribution = std::function<DeviceAddr(std::mt19937&)>;
+
+struct Workload {
+    std::string name;
+    SizeDistribution sizes;
+    // Random churn: every allocation has a 70% chance of freeing a random live one. Lifetimes: allocations are tagged
+    // short or long lived, short lived ones are freed soon after being allocated while long lived ones mostly stay
+    // around, like temporaries and weights in a model
+    bool lifetimes;
+};
+
+struct AllocatorConfig {
+    std::string name;
+    std::function<std::unique_ptr<Algorithm>(DeviceAddr bank_size, DeviceAddr alignment)> make;
+    bool use_hints = false;  // Pass the lifetimes down to FreeListOpt as allocation hints (lifetime workloads only)
+};
+
+struct Sample {
+    size_t attempt;
+    double utilization;
+    double external_fragmentation;
+    size_t free_blocks;
+};
+
+struct RunResult {
+    bool filled = false; // An allocation failed before max_attempts
+    Sample at_failure{}; // Or at max_attempts if not filled
+    std::vector<Sample> series;
+};
+
+Sample sample(const Algorithm& allocator, size_t attempt)
+{
+    auto stats = allocator.get_statistics();
+    return Sample{
+        .attempt = attempt,
+        .utilization = double(stats.total_allocated_bytes) / stats.total_allocatable_size_bytes,
+        .external_fragmentation =
+            stats.total_free_bytes == 0 ? 0.0 : 1.0 - double(stats.largest_free_block_bytes) / stats.total_free_bytes,
+        .free_blocks = allocator.available_addresses(1).size(),
+    };
+}
+
+RunResult run_workload(Algorithm& allocator, const Workload& workload, bool use_hints, size_t seed, size_t series_every)
 {
+    auto* opt = dynamic_cast<FreeListOpt*>(&allocator);
+    TT_FATAL(!use_hints || opt != nullptr, "Allocation hints are only supported by FreeListOpt");
+
     std::mt19937 gen(seed);
-    std::uniform_int_distribution<size_t> alloc_size_dist(1, alloc_size);
-    std::uniform_real_distribution<double> deallocate_dist(0.0, 1.0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    RunResult result;
+    // Churn
     std::vector<std::optional<DeviceAddr>> allocations;
+    // Lifetimes
+    std::vector<DeviceAddr> short_lived;
+    std::vector<DeviceAddr> long_lived;
+    const size_t max_short_lived = 32;
 
     size_t i = 0;
-    for (;; i++) {
-        size_t size = alloc_size_dist(gen);
-        auto addr = allocator.allocate(size);
+    for (; i < max_attempts; i++) {
+        if(series_every != 0 && i % series_every == 0) {
+            result.series.push_back(sample(allocator, i));
+        }
+        DeviceAddr size = workload.sizes(gen);
+
+        if(!workload.lifetimes) {
+            auto addr = allocator.allocate(size);
+            if(!addr.has_value()) {
+                result.filled = true;
+                break;
+            }
+            allocations.push_back(addr);
+            if(dist(gen) < 0.7) {
+                std::uniform_int_distribution<size_t> index_dist(0, allocations.size() - 1);
+                size_t index = index_dist(gen);
+                if(allocations[index].has_value()) {
+                    allocator.deallocate(*allocations[index]);
+                    allocations[index] = std::nullopt;
+                }
+            }
+            continue;
+        }
+
+        bool is_short = dist(gen) < 0.75;
+        std::optional<DeviceAddr> addr;
+        if (use_hints) {
+            auto lifetime = is_short ? FreeListOpt::Lifetime::SHORT : FreeListOpt::Lifetime::LONG;
+            addr = opt->allocate(size, FreeListOpt::AllocationHint{.lifetime = lifetime});
+        } else {
+            addr = allocator.allocate(size);
+        }
         if(!addr.has_value()) {
+            result.filled = true;
             break;
         }
-        allocations.push_back(addr);
-        if(deallocate_dist(gen) < 0.7) {
-            std::uniform_int_distribution<size_t> index_dist(0, allocations.size() - 1);
+        (is_short ? short_lived : long_lived).push_back(*addr);
+        if(short_lived.size() > max_short_lived) {
+            std::uniform_int_distribution<size_t> index_dist(0, short_lived.size() - 1);
+            size_t index = index_dist(gen);
+            allocator.deallocate(short_lived[index]);
+            short_lived.erase(short_lived.begin() + index);
+        }
+        if(!long_lived.empty() && dist(gen) < 0.24) {
+            std::uniform_int_distribution<size_t> index_dist(0, long_lived.size() - 1);
             size_t index = index_dist(gen);
-            if(allocations[index].has_value()) {
-                allocator.deallocate(*allocations[index]);
-                allocations[index] = std::nullopt;
+            allocator.deallocate(long_lived[index]);
+            long_lived.erase(long_lived.begin() + index);
+        }
+    }
+    result.at_failure = sample(allocator, i);
+    if(series_every != 0) {
+        result.series.push_back(result.at_failure);
+    }
+    return result;
+}
+
+// Sizes drawn from a histogram file, one allocation per line as "size" or "size count"
+std::optional<SizeDistribution> load_trace(const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file) {
+        return std::nullopt;
+    }
+    std::vector<DeviceAddr> sizes;
+    std::vector<double> weights;
+    std::string line;
+    while(std::getline(file, line)) {
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream ss(line);
+        DeviceAddr size = 0;
+        size_t count = 1;
+        if(!(ss >> size)) {
+            continue;
+        }
+        ss >> count;
+        sizes.push_back(size);
+        weights.push_back(count);
+    }
+    if(sizes.empty()) {
+        return std::nullopt;
+    }
+    std::discrete_distribution<size_t> index_dist(weights.begin(), weights.end());
+    return [sizes, index_dist](std::mt19937& gen) mutable { return sizes[index_dist(gen)]; };
+}
+
+std::vector<Workload> make_workloads(const std::vector<std::pair<std::string, SizeDistribution>>& traces)
+{
+    std::vector<std::pair<std::string, SizeDistribution>> distributions = {
+        {"uniform", [](std::mt19937& gen) { return std::uniform_int_distribution<DeviceAddr>(1, 16 * 1024)(gen); }},
+        // Median of 2 KiB, mostly between 512 B and 8 KiB with a long tail of large buffers
+        {"lognormal", [](std::mt19937& gen) {
+            double size = std::lognormal_distribution<double>(std::log(2048.0), 1.2)(gen);
+            return DeviceAddr(std::clamp(size, 16.0, 256.0 * 1024));
+        }},
+        // L1: semaphores and other tiny buffers next to circular buffers of 1 to 32 tiles of 2 KiB
+        {"l1_cb_semaphore", [](std::mt19937& gen) {
+            if(std::uniform_real_distribution<double>(0.0, 1.0)(gen) < 0.4) {
+                return 16 * std::uniform_int_distribution<DeviceAddr>(1, 4)(gen);
             }
+            return 2048 * std::uniform_int_distribution<DeviceAddr>(1, 32)(gen);
+        }},
+    };
+    distributions.insert(distributions.end(), traces.begin(), traces.end());
+
+    std::vector<Workload> workloads;
+    for(const auto& [name, sizes] : distributions) {
+        workloads.push_back({name + "/churn", sizes, false});
+        workloads.push_back({name + "/lifetimes", sizes, true});
+    }
+    return workloads;
+}
+
+std::vector<AllocatorConfig> make_allocators()
+{
+    auto opt = [](FreeListOpt::Options options) {
+        return [options](DeviceAddr bank_size, DeviceAddr alignment) -> std::unique_ptr<Algorithm> {
+            return std::make_unique<FreeListOpt>(bank_size, 0, alignment, alignment, options);
+        };
+    };
+    auto free_list = [](FreeList::SearchPolicy policy) {
+        return [policy](DeviceAddr bank_size, DeviceAddr alignment) -> std::unique_ptr<Algorithm> {
+            return std::make_unique<FreeList>(bank_size, 0, alignment, alignment, policy);
+        };
+    };
+    return {
+        {"FreeListOpt", opt({})},
+        {"FreeListOpt (Hinted)", opt({}), true},
+        {"FreeListOpt (Size ordered classes)", opt({.size_class_order = FreeListOpt::SizeClassOrder::SIZE})},
+        {"FreeListOpt (Quick lists)", opt({.quick_list_depth = 8})},
+        {"FreeListOpt (First fit in class)", opt({.search_policy = FreeListOpt::SearchPolicy::FIRST})},
+        {"FreeListOpt (Next fit in class)", opt({.search_policy = FreeListOpt::SearchPolicy::NEXT})},
+        {"FreeListOpt (Good enough fit in class)", opt({.search_policy = FreeListOpt::SearchPolicy::GOOD_ENOUGH})},
+        {"FreeList (First)", free_list(FreeList::SearchPolicy::FIRST)},
+        {"FreeList (Best)", free_list(FreeList::SearchPolicy::BEST)},
+    };
+}
+
+struct Run {
+    const Workload* workload;
+    const AllocatorConfig* allocator;
+    size_t seed;
+    RunResult result;
+};
+
+void print_text(const std::vector<Workload>& workloads, const std::vector<Run>& runs, size_t n_seeds)
+{
+    fmt::print("Fragmentation at the first failed allocation, mean over {} seeds (min utilization in brackets)\n", n_seeds);
+    for(const auto& workload : workloads) {
+        fmt::print("\n{}\n", workload.name);
+        fmt::print("  {:<40} {:>10} {:>20} {:>10} {:>12}\n", "", "attempts", "utilization", "ext frag", "free blocks");
+        for(size_t begin = 0; begin < runs.size(); begin += n_seeds) {
+            if(runs[begin].workload != &workload) {
+                continue;
+            }
+            double attempts = 0, utilization = 0, min_utilization = 1, external_fragmentation = 0, free_blocks = 0;
+            for(size_t i = begin; i < begin + n_seeds; i++) {
+                const Sample& at_failure = runs[i].result.at_failure;
+                attempts += at_failure.attempt;
+                utilization += at_failure.utilization;
+                min_utilization = std::min(min_utilization, at_failure.utilization);
+                external_fragmentation += at_failure.external_fragmentation;
+                free_blocks += at_failure.free_blocks;
+            }
+            fmt::print(
+                "  {:<40} {:>10.1f} {:>11.1f}% ({:>5.1f}%) {:>9.1f}% {:>12.1f}\n",
+                runs[begin].allocator->name,
+                attempts / n_seeds,
+                utilization / n_seeds * 100,
+                min_utilization * 100,
+                external_fragmentation / n_seeds * 100,
+                free_blocks / n_seeds);
+        }
+    }
+}
+
+void print_csv(const std::vector<Run>& runs, bool series)
+{
+    fmt::print("allocator,workload,seed,{}filled,utilization,external_fragmentation,free_blocks\n",
+        series ? "attempt," : "attempts,");
+    auto print_row = [](const Run& run, const Sample& sample) {
+        fmt::print("{},{},{},{},{},{:.6f},{:.6f},{}\n", run.allocator->name, run.workload->name, run.seed,
+            sample.attempt, run.result.filled ? 1 : 0, sample.utilization, sample.external_fragmentation,
+            sample.free_blocks);
+    };
+    for(const auto& run : runs) {
+        if(series) {
+            for(const auto& sample : run.result.series) {
+                print_row(run, sample);
+            }
+        } else {
+            print_row(run, run.result.at_failure);
         }
     }
-    return i;
 }
 
+void print_json(const std::vector<Run>& runs)
+{
+    fmt::print("[\n");
+    for(size_t i = 0; i < runs.size(); i++) {
+        const Run& run = runs[i];
+        const Sample& at_failure = run.result.at_failure;
+        fmt::print("  {{\"allocator\": \"{}\", \"workload\": \"{}\", \"seed\": {}, \"attempts\": {}, \"filled\": {}, "
+            "\"utilization\": {:.6f}, \"external_fragmentation\": {:.6f}, \"free_blocks\": {}",
+            run.allocator->name, run.workload->name, run.seed, at_failure.attempt, run.result.filled,
+            at_failure.utilization, at_failure.external_fragmentation, at_failure.free_blocks);
+        if(!run.result.series.empty()) {
+            // [attempt, utilization, external_fragmentation, free_blocks]
+            fmt::print(", \"series\": [");
+            for(size_t j = 0; j < run.result.series.size(); j++) {
+                const Sample& sample = run.result.series[j];
+                fmt::print("{}[{}, {:.6f}, {:.6f}, {}]", j == 0 ? "" : ", ", sample.attempt, sample.utilization,
+                    sample.external_fragmentation, sample.free_blocks);
+            }
+            fmt::print("]");
+        }
+        fmt::print("}}{}\n", i + 1 == runs.size() ? "" : ",");
+    }
+    fmt::print("]\n");
+}
 
-int main()
+int main(int argc, char** argv)
 {
-    size_t mem_size = 1.5 * 1024 * 1024; // 1.5 MB (Wormhole L1 size)
-    size_t alloc_size = 16 * 1024; // 16 KB
+    std::string format = "text";
+    size_t n_seeds = 16;
+    size_t series_every = 0;
+    DeviceAddr bank_size = 1.5 * 1024 * 1024; // 1.5 MB (Wormhole L1 size)
+    DeviceAddr alignment = 16;
+    std::vector<std::pair<std::string, SizeDistribution>> traces;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(i + 1 == argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if(arg == "--format" && (value == "text" || value == "csv" || value == "json")) {
+            format = value;
+        } else if(arg == "--seeds") {
+            n_seeds = std::max<size_t>(std::stoul(value), 1);
+        } else if(arg == "--series") {
+            series_every = std::stoul(value);
+        } else if(arg == "--bank-size") {
+            bank_size = std::stoull(value);
+        } else if(arg == "--alignment") {
+            alignment = std::stoull(value);
+        } else if(arg == "--trace") {
+            auto trace = load_trace(value);
+            if(!trace.has_value()) {
+                std::cerr << "Cannot read a size histogram from " << value << std::endl;
+                return 1;
+            }
+            traces.emplace_back("trace:" + value, *trace);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--seeds N] [--series N] [--bank-size B]"
+                      << " [--alignment B] [--trace histogram_file]..." << std::endl;
+            return 1;
+        }
+    }
+    if(format == "text") {
+        series_every = 0;
+    }
+
+    auto workloads = make_workloads(traces);
+    auto allocators = make_allocators();
+    std::vector<Run> runs;
+    for(const auto& workload : workloads) {
+        for(const auto& allocator_config : allocators) {
+            if(allocator_config.use_hints && !workload.lifetimes) {
+                continue;
+            }
+            auto allocator = allocator_config.make(bank_size, alignment);
+            for(size_t seed = 42; seed < 42 + n_seeds; seed++) {
+                allocator->clear();
+                runs.push_back({&workload, &allocator_config, seed,
+                    run_workload(*allocator, workload, allocator_config.use_hints, seed, series_every)});
+            }
+        }
+    }
 
-    tt::tt_metal::allocator::FreeListOpt opt(mem_size, 0, 16, 16);
-    tt::tt_metal::allocator::FreeList first(mem_size, 0, 16, 16, tt::tt_metal::allocator::FreeList::SearchPolicy::FIRST);
-    tt::tt_metal::allocator::FreeList best(mem_size, 0, 16, 16, tt::tt_metal::allocator::FreeList::SearchPolicy::BEST);
-    
-    std::cout << "Benchmarking fragmentation... (number of allocation attempts until full)" << std::endl;
-    std::cout << "FreeListOpt: " << test_allocator(opt, alloc_size) << std::endl;
-    std::cout << "FreeList (First): " << test_allocator(first, alloc_size) << std::endl;
-    std::cout << "FreeList (Best): " << test_allocator(best, alloc_size) << std::endl;
-}
\ No newline at end of file
+    if(format == "csv") {
+        print_csv(runs, series_every != 0);
+    } else if(format == "json") {
+        print_json(runs);
+    } else {
+        print_text(workloads, runs, n_seeds);
+    }
+}
@@ -0,0 +1,319 @@
+#include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Differential fuzzing harness. Drives FreeListOpt (in one of several configurations) and FreeList(BEST) with the
+// same operations decoded from the input bytes, checks both against a shadow model of the live allocations and
+// FreeListOpt against its own invariants (validate()) after every operation, and requires them to agree on every
+// placement when the FreeListOpt configuration is best fit.
+//
+// Build with -DTT_ALLOC_LIBFUZZER=ON (clang) for a libFuzzer target. Otherwise this is a randomized driver:
+//   tt-alloc-fuzz [iterations] [seed]
+
+using tt::tt_metal::allocator::Algorithm;
+using tt::tt_metal::allocator::FreeList;
+using tt::tt_metal::allocator::FreeListOpt;
+
+namespace {
+
+constexpr DeviceAddr bank_size = 1024 * 1024;
+constexpr DeviceAddr bank_offset = 64 * 1024;
+constexpr DeviceAddr alignment = 32;
+
+class ByteStream {
+public:
+    ByteStream(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    bool empty() const { return pos_ >= size_; }
+    template <typename T>
+    T consume() {
+        T value = 0;
+        size_t n = std::min(sizeof(T), size_ - pos_);
+        std::memcpy(&value, data_ + pos_, n);
+        pos_ += n;
+        return value;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+struct OptConfig {
+    const char* name;
+    FreeListOpt::Options options;
+    bool best_fit;  // Places exactly like FreeList(BEST)
+};
+
+const std::vector<OptConfig>& opt_configs() {
+    static const std::vector<OptConfig> configs = {
+        {"default", {}, true},
+        {"compact", {.metadata_layout = FreeListOpt::MetadataLayout::COMPACT}, true},
+        {"size ordered", {.size_class_order = FreeListOpt::SizeClassOrder::SIZE}, true},
+        {"subdivided classes", {.size_class_base = 64, .size_class_subdivisions = 4}, true},
+        {"quick lists", {.quick_list_depth = 4}, false},
+        {"first fit", {.search_policy = FreeListOpt::SearchPolicy::FIRST}, false},
+        {"next fit", {.search_policy = FreeListOpt::SearchPolicy::NEXT}, false},
+        {"good enough fit", {.search_policy = FreeListOpt::SearchPolicy::GOOD_ENOUGH}, false},
+    };
+    return configs;
+}
+
+// Live allocations of one allocator, as the allocator should see them
+struct ShadowHeap {
+    std::map<DeviceAddr, DeviceAddr> live;  // absolute address -> aligned size
+    DeviceAddr shrunk_by = 0;
+};
+
+class Harness {
+public:
+    Harness(const OptConfig& config) :
+        config_(config),
+        opt_(bank_size, bank_offset, alignment, alignment, config.options),
+        ref_(bank_size, bank_offset, alignment, alignment, FreeList::SearchPolicy::BEST) {}
+
+    void run(ByteStream& in) {
+        while (!in.empty()) {
+            step(in);
+            try {
+                opt_.validate();
+            } catch (const std::runtime_error& e) {
+                require(false, e.what());
+            }
+            check(opt_, opt_shadow_, false);
+            check(ref_, ref_shadow_, true);
+        }
+    }
+
+private:
+    void step(ByteStream& in) {
+        uint8_t op = in.consume<uint8_t>() % 16;
+        if (op < 6) {
+            // Mostly small sizes with the occasional large one
+            DeviceAddr size = in.consume<uint16_t>() % (bank_size / 16) + 1;
+            size >>= in.consume<uint8_t>() % 8;
+            bool bottom_up = op % 2 == 0;
+            log("allocate", size, bottom_up);
+            auto opt_addr = opt_.allocate(size, bottom_up);
+            auto ref_addr = ref_.allocate(size, bottom_up);
+            track(opt_shadow_, opt_addr, size);
+            track(ref_shadow_, ref_addr, size);
+            if (config_.best_fit) {
+                require(opt_addr == ref_addr, "allocate placed differently");
+            }
+        } else if (op < 8) {
+            DeviceAddr addr = bank_offset + in.consume<uint32_t>() % bank_size / alignment * alignment;
+            DeviceAddr size = in.consume<uint16_t>() % (bank_size / 64) + 1;
+            log("allocate_at_address", addr, size);
+            auto opt_addr = opt_.allocate_at_address(addr, size);
+            auto ref_addr = ref_.allocate_at_address(addr, size);
+            track(opt_shadow_, opt_addr, size);
+            track(ref_shadow_, ref_addr, size);
+            if (config_.best_fit) {
+                require(opt_addr == ref_addr, "allocate_at_address disagrees");
+            }
+        } else if (op < 13) {
+            uint16_t pick = in.consume<uint16_t>();
+            deallocate(opt_, opt_shadow_, pick);
+            deallocate(ref_, ref_shadow_, pick);
+        } else if (op < 14) {
+            // Bogus address, double free or unaligned address. All of them must be ignored
+            DeviceAddr addr = bank_offset + in.consume<uint32_t>() % bank_size;
+            log("deallocate (not allocated)", addr);
+            if (!opt_shadow_.live.count(addr)) {
+                opt_.deallocate(addr);
+            }
+            if (!ref_shadow_.live.count(addr)) {
+                ref_.deallocate(addr);
+            }
+        } else if (op < 15) {
+            DeviceAddr shrink_size = DeviceAddr(in.consume<uint16_t>()) / alignment * alignment;
+            // FreeList only shrinks once and only into a free block at the bottom
+            if (shrink_size == 0 || opt_shadow_.shrunk_by != 0 || ref_shadow_.shrunk_by != 0 ||
+                !bottom_is_free(opt_shadow_, shrink_size) || !bottom_is_free(ref_shadow_, shrink_size)) {
+                return;
+            }
+            auto lowest = ref_.lowest_occupied_address();
+            if (lowest.has_value() && *lowest - bank_offset < shrink_size) {
+                return;
+            }
+            log("shrink_size", shrink_size);
+            opt_.shrink_size(shrink_size);
+            ref_.shrink_size(shrink_size);
+            opt_shadow_.shrunk_by = ref_shadow_.shrunk_by = shrink_size;
+        } else {
+            if (opt_shadow_.shrunk_by == 0) {
+                log("clear");
+                // FreeList::clear() keeps a shrunk size, only clear when not shrunk
+                opt_.clear();
+                ref_.clear();
+                opt_shadow_.live.clear();
+                ref_shadow_.live.clear();
+                return;
+            }
+            // FreeList loses track of the block below an allocated bottom block on reset, don't go there
+            if (!bottom_is_free(opt_shadow_, opt_shadow_.shrunk_by + alignment) ||
+                !bottom_is_free(ref_shadow_, ref_shadow_.shrunk_by + alignment)) {
+                return;
+            }
+            log("reset_size");
+            opt_.reset_size();
+            ref_.reset_size();
+            opt_shadow_.shrunk_by = ref_shadow_.shrunk_by = 0;
+        }
+    }
+
+    void deallocate(Algorithm& allocator, ShadowHeap& shadow, uint16_t pick) {
+        if (shadow.live.empty()) {
+            return;
+        }
+        auto it = std::next(shadow.live.begin(), pick % shadow.live.size());
+        log("deallocate", it->first);
+        allocator.deallocate(it->first);
+        shadow.live.erase(it);
+    }
+
+    void track(ShadowHeap& shadow, std::optional<DeviceAddr> addr, DeviceAddr size) {
+        if (!addr.has_value()) {
+            return;
+        }
+        DeviceAddr aligned_size = (std::max(size, alignment) + alignment - 1) / alignment * alignment;
+        require(*addr % alignment == 0, "allocation is not aligned");
+        require(*addr >= bank_offset + shadow.shrunk_by, "allocation below the bank");
+        require(*addr + aligned_size <= bank_offset + bank_size, "allocation past the end of the bank");
+        auto next = shadow.live.lower_bound(*addr);
+        require(next == shadow.live.end() || next->first >= *addr + aligned_size, "allocation overlaps the next one");
+        require(
+            next == shadow.live.begin() || std::prev(next)->first + std::prev(next)->second <= *addr,
+            "allocation overlaps the previous one");
+        shadow.live[*addr] = aligned_size;
+    }
+
+    static bool bottom_is_free(const ShadowHeap& shadow, DeviceAddr size) {
+        return shadow.live.empty() || shadow.live.begin()->first >= bank_offset + size;
+    }
+
+    // Compare the allocator's view of memory with the shadow model
+    void check(Algorithm& allocator, const ShadowHeap& shadow, bool is_free_list) {
+        DeviceAddr live_bytes = 0;
+        for (const auto& [addr, size] : shadow.live) {
+            live_bytes += size;
+        }
+        auto stats = allocator.get_statistics();
+        require(stats.total_allocatable_size_bytes == bank_size - shadow.shrunk_by, "wrong allocatable size");
+        require(stats.total_allocated_bytes == live_bytes, "allocated bytes don't match the live allocations");
+        require(stats.total_allocated_bytes + stats.total_free_bytes == stats.total_allocatable_size_bytes,
+            "allocated and free bytes don't cover the bank");
+
+        // Free blocks are exactly the gaps between live allocations, fully coalesced, each reported once
+        std::vector<std::pair<DeviceAddr, DeviceAddr>> expected_free;
+        DeviceAddr cursor = shadow.shrunk_by;
+        for (const auto& [addr, size] : shadow.live) {
+            if (addr - bank_offset > cursor) {
+                expected_free.emplace_back(cursor, addr - bank_offset);
+            }
+            cursor = addr - bank_offset + size;
+        }
+        if (cursor < bank_size) {
+            expected_free.emplace_back(cursor, bank_size);
+        }
+        auto free_ranges = allocator.available_addresses(alignment);
+        if (is_free_list) {
+            // FreeList reports the last address an allocation of the requested size can start at
+            for (auto& [start, end] : free_ranges) {
+                end += alignment;
+            }
+        }
+        std::sort(free_ranges.begin(), free_ranges.end());
+        require(free_ranges == expected_free, "free blocks don't match the gaps between allocations");
+
+        DeviceAddr largest_free = 0;
+        for (const auto& [start, end] : expected_free) {
+            largest_free = std::max(largest_free, end - start);
+        }
+        require(stats.largest_free_block_bytes == largest_free, "wrong largest free block");
+    }
+
+    template <typename... Args>
+    void log(const char* op, Args... args) {
+        std::stringstream ss;
+        ss << op;
+        ((ss << " " << args), ...);
+        log_.push_back(ss.str());
+    }
+
+    void require(bool condition, const char* what) {
+        if (condition) {
+            return;
+        }
+        std::cerr << "FreeListOpt (" << config_.name << ") vs FreeList(BEST): " << what << std::endl;
+        std::cerr << "Operations:" << std::endl;
+        for (const auto& line : log_) {
+            std::cerr << "  " << line << std::endl;
+        }
+        std::cerr << "FreeListOpt:" << std::endl;
+        opt_.dump_blocks(std::cerr);
+        std::cerr << "FreeList:" << std::endl;
+        ref_.dump_blocks(std::cerr);
+        std::abort();
+    }
+
+    const OptConfig& config_;
+    FreeListOpt opt_;
+    FreeList ref_;
+    ShadowHeap opt_shadow_;
+    ShadowHeap ref_shadow_;
+    std::vector<std::string> log_;
+};
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    ByteStream in(data, size);
+    const auto& configs = opt_configs();
+    Harness harness(configs[in.consume<uint8_t>() % configs.size()]);
+    harness.run(in);
+    return 0;
+}
+
+#ifndef TT_ALLOC_LIBFUZZER
+int main(int argc, char** argv) {
+    size_t iterations = 1000;
+    size_t seed = 42;
+    try {
+        if (argc > 3) {
+            throw std::invalid_argument("too many arguments");
+        }
+        if (argc > 1) {
+            iterations = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            seed = std::stoul(argv[2]);
+        }
+    } catch (const std::logic_error&) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [seed]" << std::endl;
+        return 1;
+    }
+    std::mt19937 gen(seed);
+    std::vector<uint8_t> input;
+    for (size_t i = 0; i < iterations; i++) {
+        input.resize(std::uniform_int_distribution<size_t>(1, 16 * 1024)(gen));
+        for (auto& byte : input) {
+            byte = gen();
+        }
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    std::cout << "Ran " << iterations << " random inputs, no mismatch" << std::endl;
+}
+#endif
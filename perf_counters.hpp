@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters of the calling thread, read through perf_event_open. Only user space is counted.
+// Counters that can't be opened (not Linux, perf_event_paranoid too high, no PMU in the VM, ...) are left out, so
+// available() is false when none could be. Counts are scaled up if the kernel had to multiplex the counters
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        constexpr uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        constexpr uint64_t llc_read_miss = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open("l1d_misses", PERF_TYPE_HW_CACHE, l1d_read_miss);
+        open("llc_misses", PERF_TYPE_HW_CACHE, llc_read_miss);
+        open("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (const auto& counter : counters_) {
+            close(counter.fd);
+        }
+#endif
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return !counters_.empty(); }
+
+    void start() {
+#if defined(__linux__)
+        for (const auto& counter : counters_) {
+            ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // (name, count) of every available counter since start()
+    std::vector<std::pair<std::string, double>> stop() {
+        std::vector<std::pair<std::string, double>> values;
+#if defined(__linux__)
+        for (const auto& counter : counters_) {
+            ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (const auto& counter : counters_) {
+            uint64_t data[3] = {};  // value, time enabled, time running
+            if (read(counter.fd, data, sizeof(data)) != sizeof(data) || data[2] == 0) {
+                continue;
+            }
+            values.emplace_back(counter.name, double(data[0]) * data[1] / data[2]);
+        }
+#endif
+        return values;
+    }
+
+private:
+    struct Counter {
+        std::string name;
+        int fd;
+    };
+    std::vector<Counter> counters_;
+
+#if defined(__linux__)
+    void open(const char* name, uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) {
+            counters_.push_back({name, fd});
+        }
+    }
+#endif
+};
@@ -0,0 +1,57 @@
+#include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Derive a FreeListOpt size class table from a recorded allocation size histogram.
+// Input is one allocation per line, either "size" or "size count". Lines starting with # are ignored.
+// Usage: tt-alloc-size-classes <n_classes> [histogram_file]   (reads stdin without a file)
+int main(int argc, char** argv)
+{
+    if(argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <n_classes> [histogram_file]" << std::endl;
+        return 1;
+    }
+    size_t n_classes = std::stoul(argv[1]);
+    if(n_classes < 2) {
+        std::cerr << "Need at least 2 size classes" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file;
+    if(argc == 3) {
+        file.open(argv[2]);
+        if(!file) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = argc == 3 ? file : std::cin;
+
+    std::vector<std::pair<DeviceAddr, size_t>> histogram;
+    std::string line;
+    while(std::getline(in, line)) {
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream ss(line);
+        DeviceAddr size = 0;
+        size_t count = 1;
+        if(!(ss >> size)) {
+            std::cerr << "Bad line: " << line << std::endl;
+            return 1;
+        }
+        ss >> count;
+        histogram.emplace_back(size, count);
+    }
+
+    auto size_classes = tt::tt_metal::allocator::FreeListOpt::size_classes_from_histogram(histogram, n_classes);
+    // Printed as an initializer for FreeListOpt::Options::size_classes
+    std::cout << "{";
+    for(size_t i = 0; i < size_classes.size(); i++) {
+        std::cout << (i == 0 ? "" : ", ") << size_classes[i];
+    }
+    std::cout << "}" << std::endl;
+}
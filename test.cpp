@@ -1,5 +1,16 @@
 #include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include "tt_metal/impl/allocator/algorithms/allocator_handle.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list.hpp"
 #include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt_simd.hpp"
+#include "tt_metal/impl/allocator/algorithms/host_memory_resource.hpp"
+#include "tt_metal/impl/allocator/algorithms/memory_planner.hpp"
+#include "reference_free_list.hpp"
 
 // UDL to convert integer literals to SI units
 constexpr size_t operator"" _KiB(unsigned long long x) { return x * 1024; }
@@ -255,4 +266,1286 @@ TEST_CASE("Avaliable Addresses") {
         REQUIRE(aval[0].first == 3_KiB); // Start address
         REQUIRE(aval[0].second == 1_GiB); // End address
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Allocation hints") {
+    using Hint = tt::tt_metal::allocator::FreeListOpt::AllocationHint;
+    using Lifetime = tt::tt_metal::allocator::FreeListOpt::Lifetime;
+    auto allocator = tt::tt_metal::allocator::FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB);
+    SECTION("Lifetime") {
+        auto a = allocator.allocate(1_KiB, Hint{.lifetime = Lifetime::LONG});
+        REQUIRE(a.has_value());
+        REQUIRE(a.value() == 0);
+        auto b = allocator.allocate(1_KiB, Hint{.lifetime = Lifetime::SHORT});
+        REQUIRE(b.has_value());
+        REQUIRE(b.value() == 1_GiB - 1_KiB);
+    }
+
+    SECTION("Affinity") {
+        REQUIRE(allocator.allocate(1_KiB) == 0);
+        auto b = allocator.allocate(1_KiB);
+        REQUIRE(allocator.allocate(1_KiB) == 2_KiB);
+        REQUIRE(allocator.allocate(1_KiB) == 3_KiB);
+        auto e = allocator.allocate(1_KiB);
+        auto f = allocator.allocate(1_KiB);
+        REQUIRE(f.has_value());
+        allocator.deallocate(b.value());
+        allocator.deallocate(e.value());
+        // Both holes fit, pick the one next to f
+        auto g = allocator.allocate(1_KiB, Hint{.affinity_address = f.value()});
+        REQUIRE(g.has_value());
+        REQUIRE(g.value() == e.value());
+
+        // Only the top free block fits. Allocate at its end facing the affinity address, not where lifetime says
+        auto h = allocator.allocate(2_KiB, Hint{.lifetime = Lifetime::SHORT, .affinity_address = f.value()});
+        REQUIRE(h.has_value());
+        REQUIRE(h.value() == f.value() + 1_KiB);
+    }
+
+    SECTION("Affinity above the block") {
+        auto a = allocator.allocate(1_KiB);
+        auto b = allocator.allocate(2_KiB);
+        auto c = allocator.allocate(1_KiB);
+        REQUIRE(a == 0);
+        REQUIRE(c == 3_KiB);
+        allocator.deallocate(b.value());
+        // The hole at [1 KiB, 3 KiB) is the best fit, take its top end, the one facing the affinity address
+        auto d = allocator.allocate(1_KiB, Hint{.affinity_address = 60_KiB});
+        REQUIRE(d.has_value());
+        REQUIRE(d.value() == 2_KiB);
+    }
+}
+
+TEST_CASE("Memory planner") {
+    using tt::tt_metal::allocator::PlannedBuffer;
+    using tt::tt_metal::allocator::PlanningHeuristic;
+    // A chain of ops where each output is consumed by the next op: a -> b -> c -> d
+    std::vector<PlannedBuffer> buffers = {
+        {.size = 4_KiB, .first_use = 0, .last_use = 1},
+        {.size = 2_KiB, .first_use = 1, .last_use = 2},
+        {.size = 4_KiB, .first_use = 2, .last_use = 3},
+        {.size = 1_KiB, .first_use = 3, .last_use = 4},
+    };
+
+    SECTION("Buffers with disjoint lifetimes share memory") {
+        for (auto heuristic : {PlanningHeuristic::GREEDY_BY_SIZE, PlanningHeuristic::INTERVAL_COLORING, PlanningHeuristic::BEST}) {
+            auto plan = tt::tt_metal::allocator::plan_memory(buffers, heuristic);
+            REQUIRE(plan.offsets.size() == buffers.size());
+            REQUIRE(plan.lower_bound_bytes == 6_KiB);
+            REQUIRE(plan.peak_bytes >= plan.lower_bound_bytes);
+            REQUIRE(plan.peak_bytes < 11_KiB);
+            // Buffers live at the same time never overlap
+            for (size_t i = 0; i < buffers.size(); i++) {
+                for (size_t j = i + 1; j < buffers.size(); j++) {
+                    bool live_together = buffers[i].first_use <= buffers[j].last_use && buffers[j].first_use <= buffers[i].last_use;
+                    bool overlap = plan.offsets[i] < plan.offsets[j] + buffers[j].size && plan.offsets[j] < plan.offsets[i] + buffers[i].size;
+                    REQUIRE(!(live_together && overlap));
+                }
+            }
+        }
+        REQUIRE(tt::tt_metal::allocator::plan_memory(buffers).peak_bytes == 6_KiB);
+    }
+
+    SECTION("Commit") {
+        auto allocator = tt::tt_metal::allocator::FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB);
+        auto plan = tt::tt_metal::allocator::plan_memory(buffers);
+        auto committed = tt::tt_metal::allocator::commit_memory_plan(allocator, plan, 16_KiB);
+        REQUIRE(committed.has_value());
+        REQUIRE(committed->arena_address == 16_KiB);
+        for (size_t i = 0; i < buffers.size(); i++) {
+            REQUIRE(committed->addresses[i] == 16_KiB + plan.offsets[i]);
+        }
+        REQUIRE(allocator.get_statistics().total_allocated_bytes == plan.peak_bytes);
+        REQUIRE(!allocator.allocate_at_address(16_KiB, 1_KiB).has_value());
+        allocator.deallocate(committed->arena_address);
+        REQUIRE(allocator.get_statistics().total_allocated_bytes == 0);
+    }
+}
+
+TEST_CASE("Bulk allocate at address") {
+    auto allocator = tt::tt_metal::allocator::FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB);
+    auto wedge = allocator.allocate_at_address(8_KiB, 1_KiB);
+    REQUIRE(wedge.has_value());
+
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> requests = {
+        {4_KiB, 2_KiB},
+        {0, 1_KiB},
+        {8_KiB, 1_KiB},  // Already allocated
+        {7_KiB, 1_KiB},
+        {9_KiB, 3_KiB},
+        {10_KiB, 1_KiB},  // Overlaps with the previous request
+        {2_GiB, 1_KiB},   // Out of range
+    };
+    auto results = allocator.allocate_at_addresses(requests);
+    REQUIRE(results.size() == requests.size());
+    REQUIRE(results[0] == 4_KiB);
+    REQUIRE(results[1] == 0);
+    REQUIRE(!results[2].has_value());
+    REQUIRE(results[3] == 7_KiB);
+    REQUIRE(results[4] == 9_KiB);
+    REQUIRE(!results[5].has_value());
+    REQUIRE(!results[6].has_value());
+    REQUIRE(allocator.get_statistics().total_allocated_bytes == 8_KiB);
+
+    // The free space left between the requests is usable and in the right size classes
+    auto a = allocator.allocate(1_KiB);
+    REQUIRE(a.has_value());
+    REQUIRE(a.value() == 6_KiB);
+    auto b = allocator.allocate(1_KiB);
+    REQUIRE(b.has_value());
+    REQUIRE(b.value() == 1_KiB);
+    auto c = allocator.allocate(2_KiB);
+    REQUIRE(c.has_value());
+    REQUIRE(c.value() == 2_KiB);
+
+    // And everything coalesces back when freed
+    for (auto addr : {4_KiB, 0_KiB, 7_KiB, 9_KiB, 8_KiB, 6_KiB, 1_KiB, 2_KiB}) {
+        allocator.deallocate(addr);
+    }
+    auto d = allocator.allocate(1_GiB);
+    REQUIRE(d.has_value());
+
+    SECTION("Same address") {
+        // Enough duplicates that an unstable sort would reorder them. The earlier request wins, same as replaying the
+        // requests one by one with allocate_at_address
+        allocator.clear();
+        auto replayed = tt::tt_metal::allocator::FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB);
+        std::vector<std::pair<DeviceAddr, DeviceAddr>> duplicates;
+        std::vector<std::optional<DeviceAddr>> expected;
+        for (size_t i = 0; i < 64; i++) {
+            duplicates.emplace_back((i % 5) * 64_KiB, (i + 1) * 1_KiB);
+            expected.push_back(replayed.allocate_at_address(duplicates.back().first, duplicates.back().second));
+        }
+        auto duplicate_results = allocator.allocate_at_addresses(duplicates);
+        REQUIRE(duplicate_results == expected);
+        for (size_t i = 0; i < duplicates.size(); i++) {
+            REQUIRE(duplicate_results[i].has_value() == (i < 5));
+        }
+        REQUIRE(allocator.get_statistics().total_allocated_bytes == 15_KiB);
+    }
+}
+
+TEST_CASE("Metadata compaction") {
+    auto allocator = tt::tt_metal::allocator::FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB);
+    std::vector<DeviceAddr> allocations;
+    for (size_t i = 0; i < 10000; i++) {
+        allocations.push_back(allocator.allocate(1_KiB).value());
+    }
+    size_t full_bytes = allocator.metadata_memory_bytes();
+
+    SECTION("Automatic") {
+        // Free every other block first so no coalescing happens until the second pass
+        for (size_t i = 0; i < allocations.size(); i += 2) {
+            allocator.deallocate(allocations[i]);
+        }
+        for (size_t i = 1; i < allocations.size(); i += 2) {
+            allocator.deallocate(allocations[i]);
+        }
+        REQUIRE(allocator.metadata_memory_bytes() < full_bytes);
+    }
+
+    SECTION("Explicit") {
+        for (size_t i = 0; i < allocations.size(); i += 3) {
+            allocator.deallocate(allocations[i]);
+        }
+        allocator.compact_metadata();
+        REQUIRE(allocator.metadata_memory_bytes() <= full_bytes);
+        auto stats = allocator.get_statistics();
+        REQUIRE(stats.total_allocated_bytes == (allocations.size() - (allocations.size() + 2) / 3) * 1_KiB);
+        REQUIRE(stats.total_free_bytes == 1_GiB - stats.total_allocated_bytes);
+
+        // Blocks freed before compaction get reused and everything still coalesces
+        auto a = allocator.allocate(1_KiB);
+        REQUIRE(a.has_value());
+        REQUIRE(a.value() == 0);
+        for (size_t i = 0; i < allocations.size(); i++) {
+            allocator.deallocate(allocations[i]);
+        }
+        auto b = allocator.allocate(1_GiB);
+        REQUIRE(b.has_value());
+    }
+}
+
+// Run the same random sequence of operations on two allocators that are expected to behave identically
+void require_same_behavior(tt::tt_metal::allocator::FreeListOpt& a, tt::tt_metal::allocator::FreeListOpt& b, size_t n_ops, size_t seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> size_dist(1, 64_KiB);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+    std::vector<DeviceAddr> allocations;
+    for (size_t i = 0; i < n_ops; i++) {
+        int op = op_dist(gen);
+        if (op < 5 || allocations.empty()) {
+            size_t size = size_dist(gen);
+            bool bottom_up = op % 2 == 0;
+            auto addr_a = a.allocate(size, bottom_up);
+            auto addr_b = b.allocate(size, bottom_up);
+            REQUIRE(addr_a == addr_b);
+            if (addr_a.has_value()) {
+                allocations.push_back(*addr_a);
+            }
+        } else if (op < 6) {
+            DeviceAddr addr = size_dist(gen) * 512 / 32 * 32;
+            REQUIRE(a.allocate_at_address(addr, 1_KiB) == b.allocate_at_address(addr, 1_KiB));
+        } else {
+            size_t index = std::uniform_int_distribution<size_t>(0, allocations.size() - 1)(gen);
+            a.deallocate(allocations[index]);
+            b.deallocate(allocations[index]);
+            allocations.erase(allocations.begin() + index);
+        }
+    }
+    auto stats_a = a.get_statistics();
+    auto stats_b = b.get_statistics();
+    REQUIRE(stats_a.total_allocated_bytes == stats_b.total_allocated_bytes);
+    REQUIRE(stats_a.total_free_bytes == stats_b.total_free_bytes);
+    REQUIRE(stats_a.largest_free_block_bytes == stats_b.largest_free_block_bytes);
+}
+
+TEST_CASE("Compact metadata layout") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt::Options compact_options{.metadata_layout = FreeListOpt::MetadataLayout::COMPACT};
+    FreeListOpt::Options auto_options{.metadata_layout = FreeListOpt::MetadataLayout::AUTO};
+
+    SECTION("Layout selection") {
+        REQUIRE(FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB).metadata_layout() == FreeListOpt::MetadataLayout::WIDE);
+        REQUIRE(FreeListOpt(1_GiB, 0, 1_KiB, 1_KiB, auto_options).metadata_layout() == FreeListOpt::MetadataLayout::COMPACT);
+        // 2^31 alignment units does not fit
+        REQUIRE(FreeListOpt(64_GiB, 0, 32, 32, auto_options).metadata_layout() == FreeListOpt::MetadataLayout::WIDE);
+    }
+
+    SECTION("Same results as the wide layout") {
+        FreeListOpt wide(64_MiB, 0, 32, 32);
+        FreeListOpt compact(64_MiB, 0, 32, 32, compact_options);
+        require_same_behavior(wide, compact, 5000);
+        REQUIRE(wide.get_statistics().largest_free_block_addrs == compact.get_statistics().largest_free_block_addrs);
+        REQUIRE(wide.available_addresses(4_KiB) == compact.available_addresses(4_KiB));
+        REQUIRE(compact.metadata_memory_bytes() < wide.metadata_memory_bytes());
+    }
+
+    SECTION("Shrink and reset") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, compact_options);
+        REQUIRE(allocator.allocate(1_KiB, false).has_value());
+        allocator.shrink_size(4_KiB);
+        REQUIRE(!allocator.allocate_at_address(0, 1_KiB).has_value());
+        auto b = allocator.allocate(1_KiB);
+        REQUIRE(b.has_value());
+        REQUIRE(b.value() == 4_KiB);
+        allocator.reset_size();
+        auto c = allocator.allocate(1_KiB);
+        REQUIRE(c.has_value());
+        REQUIRE(c.value() == 0);
+    }
+}
+
+TEST_CASE("SIMD best fit search") {
+    namespace simd = tt::tt_metal::allocator::simd;
+    std::vector<decltype(&simd::find_best_fit)> impls = {simd::find_best_fit};
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+        impls.push_back(simd::find_best_fit_avx2);
+    }
+    if (simd::cpu_has_avx512()) {
+        impls.push_back(simd::find_best_fit_avx512);
+    }
+#endif
+    std::mt19937 gen(42);
+    for (size_t count : {0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1000}) {
+        // Few distinct sizes so there are plenty of ties and exact fits
+        std::uniform_int_distribution<DeviceAddr> size_dist(1, 20);
+        for (size_t round = 0; round < 50; round++) {
+            std::vector<DeviceAddr> sizes(count);
+            for (auto& size : sizes) {
+                size = size_dist(gen) * 1_KiB;
+            }
+            DeviceAddr alloc_size = size_dist(gen) * 1_KiB - (round % 2) * 512;
+            for (bool bottom_up : {true, false}) {
+                auto expected = simd::find_best_fit_scalar(sizes.data(), sizes.size(), alloc_size, bottom_up);
+                for (auto impl : impls) {
+                    REQUIRE(impl(sizes.data(), sizes.size(), alloc_size, bottom_up) == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Size ordered size classes") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt::Options size_ordered{.size_class_order = FreeListOpt::SizeClassOrder::SIZE};
+
+    SECTION("Same placement as address ordered classes") {
+        FreeListOpt address_ordered_allocator(64_MiB, 0, 32, 32);
+        FreeListOpt size_ordered_allocator(64_MiB, 0, 32, 32, size_ordered);
+        require_same_behavior(address_ordered_allocator, size_ordered_allocator, 20000);
+    }
+
+    SECTION("Tightest fit") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, size_ordered);
+        std::vector<DeviceAddr> allocations;
+        for (size_t i = 0; i < 16; i++) {
+            allocations.push_back(allocator.allocate((i % 4 + 1) * 1_KiB).value());
+            allocator.allocate(1_KiB);  // Keep the blocks from coalescing
+        }
+        for (auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+        // 3 KiB holes are the tightest fit. Lowest one bottom up, highest one top down
+        REQUIRE(allocator.allocate(3_KiB) == allocations[2]);
+        REQUIRE(allocator.allocate(3_KiB, false) == allocations[14]);
+
+        // Bulk allocation rebuilds the classes in the right order too
+        auto results = allocator.allocate_at_addresses({{allocations[3], 1_KiB}});
+        REQUIRE(results[0] == allocations[3]);
+        REQUIRE(allocator.allocate(3_KiB) == allocations[3] + 1_KiB);
+    }
+}
+
+TEST_CASE("Configurable size classes") {
+    using tt::tt_metal::allocator::FreeListOpt;
+
+    SECTION("Default table") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB);
+        const auto& size_classes = allocator.size_classes();
+        REQUIRE(size_classes[0] == 0);
+        REQUIRE(size_classes[1] == 2_KiB);
+        REQUIRE(size_classes[2] == 4_KiB);
+        REQUIRE(size_classes.back() == 128_MiB);
+    }
+
+    SECTION("Subdivided powers of two") {
+        FreeListOpt allocator(1_MiB, 0, 32, 32, {.size_class_base = 32, .size_class_subdivisions = 4});
+        const auto& size_classes = allocator.size_classes();
+        std::vector<DeviceAddr> expected_start = {0, 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256};
+        REQUIRE(std::equal(expected_start.begin(), expected_start.end(), size_classes.begin()));
+        REQUIRE(std::is_sorted(size_classes.begin(), size_classes.end()));
+    }
+
+    SECTION("Placement does not depend on the classes") {
+        FreeListOpt default_allocator(64_MiB, 0, 32, 32);
+        FreeListOpt subdivided_allocator(64_MiB, 0, 32, 32, {.size_class_base = 64, .size_class_subdivisions = 4});
+        require_same_behavior(default_allocator, subdivided_allocator, 20000);
+
+        default_allocator.clear();
+        FreeListOpt table_allocator(64_MiB, 0, 32, 32, {.size_classes = {0, 96, 1_KiB, 3_KiB, 100_KiB}});
+        require_same_behavior(default_allocator, table_allocator, 20000);
+    }
+
+    SECTION("Table from histogram") {
+        // Mostly small L1 buffers, with a few large ones
+        std::vector<std::pair<DeviceAddr, size_t>> histogram = {
+            {32, 400}, {64, 300}, {128, 200}, {512, 50}, {2_KiB, 40}, {64_KiB, 10}};
+        auto size_classes = FreeListOpt::size_classes_from_histogram(histogram, 4);
+        REQUIRE(size_classes == std::vector<DeviceAddr>{0, 64, 128, 64_KiB + 1});
+
+        FreeListOpt allocator(1_MiB, 0, 32, 32, {.size_classes = size_classes});
+        REQUIRE(allocator.allocate(32).has_value());
+        REQUIRE(allocator.allocate(64_KiB).has_value());
+
+        REQUIRE(FreeListOpt::size_classes_from_histogram({}, 4) == std::vector<DeviceAddr>{0});
+    }
+}
+
+TEST_CASE("Quick lists") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt::Options quick_options{.quick_list_depth = 4, .quick_list_max_size = 64_KiB};
+
+    SECTION("Reuse the last freed block of the same size") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, quick_options);
+        auto a = allocator.allocate(1_KiB);
+        auto b = allocator.allocate(1_KiB);
+        auto c = allocator.allocate(1_KiB);
+        allocator.deallocate(*a);
+        allocator.deallocate(*c);
+        // Not coalesced, but still counted as free
+        auto stats = allocator.get_statistics();
+        REQUIRE(stats.total_allocated_bytes == 1_KiB);
+        REQUIRE(stats.total_free_bytes == 1_GiB - 1_KiB);
+        REQUIRE(stats.largest_free_block_bytes == 1_GiB - 2_KiB);
+        REQUIRE(allocator.available_addresses(1_KiB).size() == 2);
+
+        REQUIRE(allocator.allocate(1_KiB) == c);
+        REQUIRE(allocator.allocate(1_KiB) == a);
+        allocator.deallocate(*b);
+        allocator.deallocate(*a);
+        allocator.deallocate(*c);
+        allocator.flush_quick_lists();
+        REQUIRE(allocator.available_addresses(1_KiB).size() == 1);
+    }
+
+    SECTION("Depth and size limits") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, quick_options);
+        std::vector<DeviceAddr> allocations;
+        for (size_t i = 0; i < 6; i++) {
+            allocations.push_back(allocator.allocate(1_KiB).value());
+            allocator.allocate(1_KiB);  // Keep the blocks from coalescing
+        }
+        for (auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+        // Only the last 4 are parked, the first 2 went back to the free list
+        for (size_t i = 0; i < 4; i++) {
+            REQUIRE(allocator.allocate(1_KiB) == allocations[5 - i]);
+        }
+        REQUIRE(allocator.allocate(1_KiB) == allocations[0]);
+
+        // Too large to be parked
+        auto big = allocator.allocate(128_KiB);
+        allocator.deallocate(*big);
+        REQUIRE(allocator.available_addresses(128_KiB).back().first == *big);
+    }
+
+    SECTION("Flush when an allocation would fail") {
+        FreeListOpt allocator(16_KiB, 0, 1_KiB, 1_KiB, quick_options);
+        std::vector<DeviceAddr> allocations;
+        for (size_t i = 0; i < 16; i++) {
+            allocations.push_back(allocator.allocate(1_KiB).value());
+        }
+        allocator.deallocate(allocations[4]);
+        allocator.deallocate(allocations[5]);
+        REQUIRE(allocator.allocate(2_KiB) == allocations[4]);
+        REQUIRE(!allocator.allocate(1_KiB).has_value());
+    }
+
+    SECTION("Explicit placement flushes") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, quick_options);
+        auto a = allocator.allocate(1_KiB);
+        allocator.allocate(1_KiB);
+        allocator.deallocate(*a);
+        REQUIRE(allocator.allocate_at_address(*a, 1_KiB) == a);
+        allocator.deallocate(*a);
+        allocator.shrink_size(1_KiB);
+        allocator.reset_size();
+        REQUIRE(allocator.allocate(1_KiB) == a);
+    }
+
+    SECTION("Random workload") {
+        FreeListOpt allocator(8_MiB, 0, 32, 32, quick_options);
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<size_t> size_dist(1, 16);
+        std::map<DeviceAddr, DeviceAddr> live;
+        DeviceAddr live_bytes = 0;
+        for (size_t i = 0; i < 20000; i++) {
+            if (gen() % 2 == 0 || live.empty()) {
+                DeviceAddr size = size_dist(gen) * 512;
+                auto addr = allocator.allocate(size);
+                if (!addr.has_value()) {
+                    continue;
+                }
+                auto next = live.lower_bound(*addr);
+                REQUIRE((next == live.end() || next->first >= *addr + size));
+                REQUIRE((next == live.begin() || std::prev(next)->first + std::prev(next)->second <= *addr));
+                live[*addr] = size;
+                live_bytes += size;
+            } else {
+                auto it = std::next(live.begin(), gen() % live.size());
+                allocator.deallocate(it->first);
+                live_bytes -= it->second;
+                live.erase(it);
+            }
+            if (i % 1000 == 0) {
+                allocator.compact_metadata();
+                REQUIRE(allocator.get_statistics().total_allocated_bytes == live_bytes);
+            }
+        }
+        for (const auto& [addr, size] : live) {
+            allocator.deallocate(addr);
+        }
+        REQUIRE(allocator.get_statistics().largest_free_block_bytes == 8_MiB);
+        allocator.flush_quick_lists();
+        REQUIRE(allocator.available_addresses(8_MiB).size() == 1);
+    }
+}
+
+TEST_CASE("Search policies") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    // Holes of 3, 2 and 3 KiB (all in the [2 KiB, 4 KiB) class) separated by allocated blocks
+    auto make_holes = [](FreeListOpt& allocator) {
+        std::vector<DeviceAddr> holes;
+        for (DeviceAddr size : {3_KiB, 2_KiB, 3_KiB}) {
+            holes.push_back(allocator.allocate(size).value());
+            allocator.allocate(1_KiB);
+        }
+        for (auto addr : holes) {
+            allocator.deallocate(addr);
+        }
+        return holes;
+    };
+
+    SECTION("Best") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB);
+        auto holes = make_holes(allocator);
+        REQUIRE(allocator.allocate(2_KiB) == holes[1]);
+    }
+
+    SECTION("First") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, {.search_policy = FreeListOpt::SearchPolicy::FIRST});
+        auto holes = make_holes(allocator);
+        REQUIRE(allocator.allocate(2_KiB) == holes[0]);
+        REQUIRE(allocator.allocate(2_KiB, false) == holes[2] + 1_KiB);
+    }
+
+    SECTION("Next") {
+        FreeListOpt allocator(1_GiB, 0, 1_KiB, 1_KiB, {.search_policy = FreeListOpt::SearchPolicy::NEXT});
+        auto holes = make_holes(allocator);
+        REQUIRE(allocator.allocate(3_KiB) == holes[0]);
+        REQUIRE(allocator.allocate(2_KiB) == holes[1]);
+        allocator.deallocate(holes[0]);
+        // Continues after the last allocation instead of going back to the first hole
+        REQUIRE(allocator.allocate(2_KiB) == holes[2]);
+        // Wraps around
+        REQUIRE(allocator.allocate(2_KiB) == holes[0]);
+    }
+
+    SECTION("Good enough") {
+        FreeListOpt tight(1_GiB, 0, 1_KiB, 1_KiB, {.search_policy = FreeListOpt::SearchPolicy::GOOD_ENOUGH});
+        auto holes = make_holes(tight);
+        REQUIRE(tight.allocate(2_KiB) == holes[1]);
+
+        FreeListOpt loose(
+            1_GiB, 0, 1_KiB, 1_KiB, {.search_policy = FreeListOpt::SearchPolicy::GOOD_ENOUGH, .good_enough_slack = 0.5});
+        holes = make_holes(loose);
+        REQUIRE(loose.allocate(2_KiB) == holes[0]);
+    }
+
+    SECTION("Random workload") {
+        for (auto policy : {FreeListOpt::SearchPolicy::FIRST, FreeListOpt::SearchPolicy::NEXT, FreeListOpt::SearchPolicy::GOOD_ENOUGH}) {
+            FreeListOpt allocator(8_MiB, 0, 32, 32, {.search_policy = policy});
+            std::mt19937 gen(42);
+            std::map<DeviceAddr, DeviceAddr> live;
+            DeviceAddr live_bytes = 0;
+            for (size_t i = 0; i < 10000; i++) {
+                if (gen() % 2 == 0 || live.empty()) {
+                    DeviceAddr size = (gen() % 64 + 1) * 256;
+                    auto addr = allocator.allocate(size, gen() % 2 == 0);
+                    if (!addr.has_value()) {
+                        continue;
+                    }
+                    auto next = live.lower_bound(*addr);
+                    REQUIRE((next == live.end() || next->first >= *addr + size));
+                    REQUIRE((next == live.begin() || std::prev(next)->first + std::prev(next)->second <= *addr));
+                    live[*addr] = size;
+                    live_bytes += size;
+                } else {
+                    auto it = std::next(live.begin(), gen() % live.size());
+                    allocator.deallocate(it->first);
+                    live_bytes -= it->second;
+                    live.erase(it);
+                }
+            }
+            REQUIRE(allocator.get_statistics().total_allocated_bytes == live_bytes);
+        }
+    }
+}
+
+// Random operations against the old boost::local_shared_ptr FreeList, every result and the block list must match
+void require_same_as_reference_free_list(tt::tt_metal::allocator::FreeList::SearchPolicy policy, size_t n_ops, size_t seed) {
+    using tt::tt_metal::allocator::FreeList;
+    using tt::tt_metal::allocator::ReferenceFreeList;
+    const DeviceAddr offset = 64_KiB;
+    FreeList allocator(8_MiB, offset, 64, 32, policy);
+    ReferenceFreeList reference(8_MiB, offset, 64, 32, ReferenceFreeList::SearchPolicy(policy));
+
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> size_dist(1, 256_KiB);
+    std::uniform_int_distribution<int> op_dist(0, 99);
+    std::map<DeviceAddr, DeviceAddr> live;
+    DeviceAddr shrunk_by = 0;
+    for (size_t i = 0; i < n_ops; i++) {
+        int op = op_dist(gen);
+        if (op < 45 || live.empty()) {
+            size_t size = size_dist(gen) >> (gen() % 8);
+            bool bottom_up = op % 2 == 0;
+            auto addr = allocator.allocate(size, bottom_up);
+            REQUIRE(addr == reference.allocate(size, bottom_up));
+            if (addr.has_value()) {
+                live[*addr] = size;
+            }
+        } else if (op < 55) {
+            DeviceAddr addr = offset + (size_dist(gen) * 32) / 32 * 32;
+            DeviceAddr size = size_dist(gen) / 16;
+            auto result = allocator.allocate_at_address(addr, size);
+            REQUIRE(result == reference.allocate_at_address(addr, size));
+            if (result.has_value()) {
+                live[*result] = size;
+            }
+        } else if (op < 90) {
+            auto it = std::next(live.begin(), gen() % live.size());
+            allocator.deallocate(it->first);
+            reference.deallocate(it->first);
+            live.erase(it);
+        } else if (op < 92) {
+            // Not allocated, both ignore it
+            DeviceAddr addr = offset + size_dist(gen) * 32;
+            allocator.deallocate(addr);
+            reference.deallocate(addr);
+            live.erase(addr);
+        } else if (op < 94 && shrunk_by == 0) {
+            auto lowest_occupied = reference.lowest_occupied_address();
+            DeviceAddr lowest = lowest_occupied.has_value() ? *lowest_occupied - offset : 8_MiB;
+            DeviceAddr shrink_size = std::min<DeviceAddr>(lowest, 64_KiB) / 32 * 32;
+            // Shrinking needs a free block at the bottom
+            auto free_ranges = reference.available_addresses(shrink_size);
+            if (shrink_size != 0 && !free_ranges.empty() && free_ranges[0].first == 0) {
+                allocator.shrink_size(shrink_size);
+                reference.shrink_size(shrink_size);
+                shrunk_by = shrink_size;
+            }
+        } else if (op < 96) {
+            // Only reset while the bottom block is free. When it's allocated, both leave the block below it unlinked
+            // and the block lists get out of sync with the free lists, which isn't worth reproducing here
+            auto free_ranges = reference.available_addresses(1);
+            if (shrunk_by == 0 || (!free_ranges.empty() && free_ranges[0].first == shrunk_by)) {
+                allocator.reset_size();
+                reference.reset_size();
+                shrunk_by = 0;
+            }
+        } else if (op < 97) {
+            allocator.clear();
+            reference.clear();
+            live.clear();
+            shrunk_by = 0;
+        } else {
+            DeviceAddr size = size_dist(gen);
+            REQUIRE(allocator.available_addresses(size) == reference.available_addresses(size));
+            REQUIRE(allocator.lowest_occupied_address() == reference.lowest_occupied_address());
+            auto stats = allocator.get_statistics();
+            auto reference_stats = reference.get_statistics();
+            REQUIRE(stats.total_allocated_bytes == reference_stats.total_allocated_bytes);
+            REQUIRE(stats.total_free_bytes == reference_stats.total_free_bytes);
+            REQUIRE(stats.largest_free_block_bytes == reference_stats.largest_free_block_bytes);
+            REQUIRE(stats.largest_free_block_addrs == reference_stats.largest_free_block_addrs);
+            std::stringstream dump, reference_dump;
+            allocator.dump_blocks(dump);
+            reference.dump_blocks(reference_dump);
+            REQUIRE(dump.str() == reference_dump.str());
+        }
+    }
+}
+
+TEST_CASE("Available addresses without allocating") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    for (size_t quick_list_depth : {0, 4}) {
+        FreeListOpt allocator(4_MiB, 0, 32, 32, {.quick_list_depth = quick_list_depth});
+        std::mt19937 gen(42);
+        std::vector<DeviceAddr> allocations;
+        for (size_t i = 0; i < 1000; i++) {
+            allocations.push_back(allocator.allocate((gen() % 32 + 1) * 64, gen() % 2 == 0).value());
+        }
+        for (size_t i = 0; i < 500; i++) {
+            size_t index = gen() % allocations.size();
+            allocator.deallocate(allocations[index]);
+            allocations.erase(allocations.begin() + index);
+        }
+
+        for (DeviceAddr size : {DeviceAddr{1}, 1_KiB, 2_KiB}) {
+            auto expected = allocator.available_addresses(size);
+            std::sort(expected.begin(), expected.end());
+            REQUIRE(expected.size() > 4);
+
+            std::vector<std::pair<DeviceAddr, DeviceAddr>> buffer(expected.size() + 1);
+            REQUIRE(allocator.available_addresses(size, buffer.data(), buffer.size()) == expected.size());
+            buffer.resize(expected.size());
+            REQUIRE(buffer == expected);
+
+            // Stops at the capacity
+            REQUIRE(allocator.available_addresses(size, buffer.data(), 3) == 3);
+            REQUIRE(std::equal(buffer.begin(), buffer.begin() + 3, expected.begin()));
+            REQUIRE(allocator.available_addresses(size, buffer.data(), 0) == 0);
+
+            // Stops when the visitor says so
+            std::vector<std::pair<DeviceAddr, DeviceAddr>> visited;
+            allocator.for_each_available_address(size, [&](DeviceAddr start, DeviceAddr end) {
+                visited.emplace_back(start, end);
+                return end - start < 4_KiB;
+            });
+            auto first_large = std::find_if(expected.begin(), expected.end(), [](const auto& range) {
+                return range.second - range.first >= 4_KiB;
+            });
+            REQUIRE(visited == std::vector<std::pair<DeviceAddr, DeviceAddr>>(expected.begin(), first_large + 1));
+        }
+    }
+}
+
+TEST_CASE("Common free address across banks") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    for (size_t quick_list_depth : {0, 4}) {
+        std::vector<std::unique_ptr<FreeListOpt>> banks;
+        std::vector<const FreeListOpt*> bank_ptrs;
+        for (size_t bank = 0; bank < 8; bank++) {
+            banks.push_back(std::make_unique<FreeListOpt>(
+                1_MiB, 0, 32, 32, FreeListOpt::Options{.quick_list_depth = quick_list_depth}));
+            bank_ptrs.push_back(banks.back().get());
+            std::mt19937 gen(bank);
+            std::vector<DeviceAddr> allocations;
+            for (size_t i = 0; i < 200; i++) {
+                allocations.push_back(banks.back()->allocate((gen() % 32 + 1) * 64, gen() % 2 == 0).value());
+            }
+            for (size_t i = 0; i < 150; i++) {
+                size_t index = gen() % allocations.size();
+                banks.back()->deallocate(allocations[index]);
+                allocations.erase(allocations.begin() + index);
+            }
+        }
+
+        // Every lowest (highest) common address starts (ends) at the edge of some bank's free range
+        auto brute_force = [&](DeviceAddr size, bool bottom_up) -> std::optional<DeviceAddr> {
+            std::vector<std::vector<std::pair<DeviceAddr, DeviceAddr>>> ranges;
+            std::vector<DeviceAddr> candidates;
+            for (const auto& bank : banks) {
+                ranges.push_back(bank->available_addresses(size));
+                for (const auto& [start, end] : ranges.back()) {
+                    candidates.push_back(bottom_up ? start : end - size);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+            if (!bottom_up) {
+                std::reverse(candidates.begin(), candidates.end());
+            }
+            for (DeviceAddr candidate : candidates) {
+                bool free_everywhere = std::all_of(ranges.begin(), ranges.end(), [&](const auto& bank_ranges) {
+                    return std::any_of(bank_ranges.begin(), bank_ranges.end(), [&](const auto& range) {
+                        return range.first <= candidate && candidate + size <= range.second;
+                    });
+                });
+                if (free_everywhere) {
+                    return candidate;
+                }
+            }
+            return std::nullopt;
+        };
+
+        size_t n_found = 0;
+        for (DeviceAddr size : {1_KiB, 4_KiB, 16_KiB, 64_KiB}) {
+            for (bool bottom_up : {true, false}) {
+                auto address = FreeListOpt::find_common_free_address(bank_ptrs, size, bottom_up);
+                REQUIRE(address == brute_force(size, bottom_up));
+                n_found += address.has_value();
+            }
+        }
+        REQUIRE(n_found >= 4);
+        REQUIRE_FALSE(FreeListOpt::find_common_free_address(bank_ptrs, 2_MiB).has_value());
+        REQUIRE_FALSE(FreeListOpt::find_common_free_address({}, 1_KiB).has_value());
+
+        // The address can be allocated in every bank
+        auto address = FreeListOpt::find_common_free_address(bank_ptrs, 4_KiB);
+        REQUIRE(address.has_value());
+        for (auto& bank : banks) {
+            REQUIRE(bank->allocate_at_address(*address, 4_KiB) == address);
+        }
+        auto next = FreeListOpt::find_common_free_address(bank_ptrs, 4_KiB);
+        REQUIRE(next.has_value());
+        REQUIRE(*next >= *address + 4_KiB);
+    }
+}
+
+TEST_CASE("Allocator handle") {
+    using tt::tt_metal::allocator::AllocatorHandle;
+    using tt::tt_metal::allocator::FreeList;
+    using tt::tt_metal::allocator::FreeListOpt;
+    AllocatorHandle opt(std::in_place_type<FreeListOpt>, 1_MiB, 0, 32, 32);
+    AllocatorHandle ref(std::in_place_type<FreeList>, 1_MiB, 0, 32, 32, FreeList::SearchPolicy::BEST);
+    REQUIRE(opt.get_if<FreeListOpt>() != nullptr);
+    REQUIRE(opt.get_if<FreeList>() == nullptr);
+    REQUIRE(ref.get_if<FreeList>() != nullptr);
+
+    // Both the handle and the Algorithm interface drive the same allocator
+    for (AllocatorHandle* handle : {&opt, &ref}) {
+        auto a = handle->allocate(1_KiB);
+        auto b = handle->algorithm().allocate(1_KiB);
+        auto c = handle->allocate(2_KiB, false);
+        REQUIRE(a == 0);
+        REQUIRE(b == 1_KiB);
+        REQUIRE(c == 1_MiB - 2_KiB);
+        REQUIRE(handle->allocate_at_address(64_KiB, 1_KiB) == 64_KiB);
+        handle->algorithm().deallocate(*a);
+        handle->deallocate(*c);
+        REQUIRE(handle->get_statistics().total_allocated_bytes == 2_KiB);
+        REQUIRE(handle->algorithm().get_statistics().total_allocated_bytes == 2_KiB);
+        REQUIRE(handle->align(33) == 64);
+        handle->clear();
+        REQUIRE(handle->get_statistics().total_allocated_bytes == 0);
+    }
+    REQUIRE(opt.visit([](auto& allocator) { return allocator.max_size_bytes(); }) == 1_MiB);
+}
+
+TEST_CASE("Host memory resource") {
+    using tt::tt_metal::allocator::HostMemoryResource;
+    SECTION("Mapped region") {
+        HostMemoryResource resource(1_MiB);
+        std::byte* base = static_cast<std::byte*>(resource.base());
+        void* a = resource.allocate(1000);
+        void* b = resource.allocate(3000, 8);
+        REQUIRE(a == base);
+        REQUIRE(b == base + 1008);
+        std::memset(a, 0xab, 1000);
+        std::memset(b, 0xcd, 3000);
+        REQUIRE(resource.get_statistics().total_allocated_bytes == 1008 + 3008);
+
+        // Over aligned requests land on an aligned host address
+        void* page = resource.allocate(100, 4_KiB);
+        REQUIRE(reinterpret_cast<uintptr_t>(page) % 4_KiB == 0);
+        REQUIRE(page == base + 4_KiB);
+        resource.deallocate(page, 100, 4_KiB);
+
+        resource.deallocate(a, 1000);
+        resource.deallocate(b, 3000, 8);
+        REQUIRE(resource.get_statistics().total_allocated_bytes == 0);
+
+        // Containers use it like any other resource
+        std::pmr::vector<int> values(&resource);
+        for (int i = 0; i < 10000; i++) {
+            values.push_back(i);
+        }
+        REQUIRE(values[9999] == 9999);
+        REQUIRE(static_cast<void*>(values.data()) >= resource.base());
+        REQUIRE(resource.get_statistics().total_allocated_bytes == values.capacity() * sizeof(int));
+
+        REQUIRE_THROWS_AS(resource.allocate(2_MiB), std::bad_alloc);
+        REQUIRE(resource.is_equal(resource));
+    }
+
+    SECTION("Given region") {
+        std::vector<std::byte> region(64_KiB + 64);
+        void* base = region.data() + (64 - reinterpret_cast<uintptr_t>(region.data()) % 64) % 64;
+        HostMemoryResource resource(base, 64_KiB, 64);
+        std::vector<void*> allocations;
+        for (size_t i = 0; i < 64; i++) {
+            allocations.push_back(resource.allocate(1_KiB));
+            REQUIRE(allocations.back() == static_cast<std::byte*>(base) + i * 1_KiB);
+        }
+        REQUIRE_THROWS_AS(resource.allocate(1), std::bad_alloc);
+        resource.deallocate(allocations[10], 1_KiB);
+        REQUIRE(resource.allocate(1_KiB) == allocations[10]);
+        resource.release();
+        REQUIRE(resource.get_statistics().total_allocated_bytes == 0);
+        REQUIRE(resource.allocate(64_KiB) == base);
+    }
+}
+
+TEST_CASE("Serialize and deserialize") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    auto json = [](const FreeListOpt& allocator) {
+        std::stringstream ss;
+        allocator.dump_blocks(ss, FreeListOpt::DumpFormat::JSON);
+        return ss.str();
+    };
+    auto churn = [](FreeListOpt& allocator, size_t seed, size_t n_ops) {
+        std::mt19937 gen(seed);
+        std::vector<std::optional<DeviceAddr>> results;
+        std::vector<DeviceAddr> live;
+        for (size_t i = 0; i < n_ops; i++) {
+            if (live.empty() || gen() % 3 != 0) {
+                auto addr = allocator.allocate((gen() % 64 + 1) * 96, gen() % 2 == 0);
+                results.push_back(addr);
+                if (addr.has_value()) {
+                    live.push_back(*addr);
+                }
+            } else {
+                size_t index = gen() % live.size();
+                allocator.deallocate(live[index]);
+                live.erase(live.begin() + index);
+            }
+        }
+        return results;
+    };
+
+    for (auto layout : {FreeListOpt::MetadataLayout::WIDE, FreeListOpt::MetadataLayout::COMPACT}) {
+        for (size_t quick_list_depth : {0, 4}) {
+            FreeListOpt::Options options{.metadata_layout = layout, .quick_list_depth = quick_list_depth};
+            FreeListOpt saved(4_MiB, 64_KiB, 32, 32, options);
+            saved.shrink_size(64_KiB);
+            churn(saved, 1, 2000);
+            auto blob = saved.serialize();
+            REQUIRE(blob.size() % 8 == 0);
+
+            FreeListOpt loaded(4_MiB, 64_KiB, 32, 32, options);
+            loaded.deserialize(blob.data(), blob.size());
+            loaded.validate();
+            REQUIRE(json(loaded) == json(saved));
+            // Picks up exactly where the saved one left off
+            REQUIRE(churn(loaded, 2, 500) == churn(saved, 2, 500));
+            REQUIRE(json(loaded) == json(saved));
+
+            // Different size classes or no quick lists still load
+            blob = saved.serialize();
+            FreeListOpt reclassed(
+                4_MiB, 64_KiB, 32, 32, {.metadata_layout = layout, .size_class_base = 64, .size_class_subdivisions = 4});
+            reclassed.deserialize(blob.data(), blob.size());
+            reclassed.validate();
+            REQUIRE(reclassed.get_statistics().total_allocated_bytes == saved.get_statistics().total_allocated_bytes);
+            REQUIRE(reclassed.get_statistics().total_free_bytes == saved.get_statistics().total_free_bytes);
+        }
+    }
+
+    SECTION("Bad blobs are rejected and leave the allocator as it was") {
+        FreeListOpt saved(1_MiB, 0, 32, 32, {.metadata_layout = FreeListOpt::MetadataLayout::WIDE});
+        churn(saved, 3, 200);
+        auto blob = saved.serialize();
+        FreeListOpt loaded(1_MiB, 0, 32, 32, {.metadata_layout = FreeListOpt::MetadataLayout::WIDE});
+        churn(loaded, 4, 50);
+        std::string before = json(loaded);
+
+        auto corrupted = blob;
+        corrupted[corrupted.size() / 2] ^= 1;
+        REQUIRE_THROWS_AS(loaded.deserialize(corrupted.data(), corrupted.size()), std::runtime_error);
+        REQUIRE_THROWS_AS(loaded.deserialize(blob.data(), blob.size() - 8), std::runtime_error);
+        REQUIRE_THROWS_AS(loaded.deserialize(blob.data(), 16), std::runtime_error);
+        auto bad_magic = blob;
+        bad_magic[0] = 'X';
+        REQUIRE_THROWS_AS(loaded.deserialize(bad_magic.data(), bad_magic.size()), std::runtime_error);
+        REQUIRE(json(loaded) == before);
+
+        FreeListOpt other_bank(2_MiB, 0, 32, 32, {.metadata_layout = FreeListOpt::MetadataLayout::WIDE});
+        REQUIRE_THROWS_AS(other_bank.deserialize(blob.data(), blob.size()), std::runtime_error);
+        FreeListOpt other_layout(1_MiB, 0, 32, 32, {.metadata_layout = FreeListOpt::MetadataLayout::COMPACT});
+        REQUIRE_THROWS_AS(other_layout.deserialize(blob.data(), blob.size()), std::runtime_error);
+
+        // Intact blob, but its quick lists are deeper than this allocator allows
+        FreeListOpt deep(1_MiB, 0, 32, 32, {.quick_list_depth = 4});
+        std::vector<DeviceAddr> parked;
+        for (size_t i = 0; i < 4; i++) {
+            parked.push_back(deep.allocate(1_KiB).value());
+            deep.allocate(1_KiB);
+        }
+        for (DeviceAddr address : parked) {
+            deep.deallocate(address);
+        }
+        auto deep_blob = deep.serialize();
+        FreeListOpt shallow(1_MiB, 0, 32, 32, {.quick_list_depth = 2});
+        churn(shallow, 5, 50);
+        std::string shallow_before = json(shallow);
+        REQUIRE_THROWS_AS(shallow.deserialize(deep_blob.data(), deep_blob.size()), std::runtime_error);
+        REQUIRE(json(shallow) == shallow_before);
+    }
+}
+
+TEST_CASE("Tenant quotas") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt allocator(1_MiB, 64_KiB, 1_KiB, 1_KiB);
+    auto model_a = allocator.add_tenant("model_a", 8_KiB);
+    auto model_b = allocator.add_tenant("model_b");
+    size_t n_oom_calls = 0;
+    allocator.set_on_oom([&](const FreeListOpt::OutOfMemoryEvent&) {
+        n_oom_calls++;
+        return false;
+    });
+
+    auto a0 = allocator.allocate_for_tenant(model_a, 3_KiB);
+    auto a1 = allocator.allocate_for_tenant(model_a, 4000);  // Charged 4 KiB after alignment
+    auto b0 = allocator.allocate_for_tenant(model_b, 100_KiB);
+    auto untracked = allocator.allocate(10_KiB);
+    REQUIRE(a0.has_value());
+    REQUIRE(a1.has_value());
+    REQUIRE(b0.has_value());
+    REQUIRE(untracked.has_value());
+
+    // Over the quota fails without looking for memory, while the bank still has room
+    REQUIRE_FALSE(allocator.allocate_for_tenant(model_a, 2_KiB).has_value());
+    REQUIRE_FALSE(allocator.allocate_at_address_for_tenant(model_a, 512_KiB, 2_KiB).has_value());
+    REQUIRE(n_oom_calls == 0);
+    auto a2 = allocator.allocate_for_tenant(model_a, 1_KiB);
+    REQUIRE(a2.has_value());
+
+    auto stats = allocator.get_statistics();
+    REQUIRE(stats.tenants.size() == 2);
+    REQUIRE(stats.tenants[model_a].name == "model_a");
+    REQUIRE(stats.tenants[model_a].quota_bytes == 8_KiB);
+    REQUIRE(stats.tenants[model_a].allocated_bytes == 8_KiB);
+    REQUIRE(stats.tenants[model_a].num_allocations == 3);
+    REQUIRE(stats.tenants[model_a].num_quota_failures == 2);
+    REQUIRE(stats.tenants[model_b].allocated_bytes == 100_KiB);
+    REQUIRE(stats.tenants[model_b].quota_bytes == FreeListOpt::unlimited_quota);
+    REQUIRE(stats.total_allocated_bytes == 118_KiB);
+
+    // Deallocating gives the bytes back, untracked and bogus addresses don't touch the tenants
+    allocator.deallocate(*a1);
+    allocator.deallocate(*untracked);
+    allocator.deallocate(*a1);
+    stats = allocator.get_statistics();
+    REQUIRE(stats.tenants[model_a].allocated_bytes == 4_KiB);
+    REQUIRE(stats.tenants[model_a].peak_allocated_bytes == 8_KiB);
+    REQUIRE(stats.tenants[model_a].num_allocations == 2);
+    REQUIRE(allocator.allocate_at_address_for_tenant(model_a, 512_KiB, 4_KiB) == 512_KiB);
+    REQUIRE(allocator.get_statistics().tenants[model_a].allocated_bytes == 8_KiB);
+
+    // A lower quota stops new allocations without taking any away
+    allocator.set_tenant_quota(model_b, 50_KiB);
+    REQUIRE_FALSE(allocator.allocate_for_tenant(model_b, 1_KiB).has_value());
+    allocator.deallocate(*b0);
+    REQUIRE(allocator.allocate_for_tenant(model_b, 1_KiB).has_value());
+
+    // Real out of memory still goes through on_oom
+    allocator.set_tenant_quota(model_b, FreeListOpt::unlimited_quota);
+    REQUIRE_FALSE(allocator.allocate_for_tenant(model_b, 2_MiB).has_value());
+    REQUIRE(n_oom_calls == 1);
+
+    allocator.clear();
+    stats = allocator.get_statistics();
+    REQUIRE(stats.tenants[model_a].allocated_bytes == 0);
+    REQUIRE(stats.tenants[model_b].allocated_bytes == 0);
+    REQUIRE(stats.tenants[model_a].num_allocations == 0);
+    REQUIRE(stats.tenants[model_a].num_quota_failures == 2);
+}
+
+TEST_CASE("Memory pressure callbacks") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt allocator(16_KiB, 0, 1_KiB, 1_KiB);
+    std::vector<DeviceAddr> allocations;
+    for (size_t i = 0; i < 16; i++) {
+        allocations.push_back(allocator.allocate(1_KiB).value());
+    }
+
+    SECTION("Evict and retry") {
+        std::vector<FreeListOpt::OutOfMemoryEvent> events;
+        allocator.set_on_oom([&](const FreeListOpt::OutOfMemoryEvent& event) {
+            events.push_back(event);
+            allocator.deallocate(allocations[4]);
+            allocator.deallocate(allocations[5]);
+            return true;
+        });
+        REQUIRE(allocator.allocate(1500) == allocations[4]);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].size_bytes == 1500);
+        REQUIRE(events[0].alloc_size == 2_KiB);
+        REQUIRE(events[0].statistics.total_free_bytes == 0);
+        REQUIRE(events[0].external_fragmentation == 0.0);
+    }
+
+    SECTION("Retry once") {
+        size_t n_calls = 0;
+        allocator.set_on_oom([&](const FreeListOpt::OutOfMemoryEvent& /*event*/) {
+            n_calls++;
+            // Failing allocations from the callback don't call it again
+            REQUIRE(!allocator.allocate(1_KiB).has_value());
+            return true;
+        });
+        REQUIRE(!allocator.allocate(1_KiB).has_value());
+        REQUIRE(n_calls == 1);
+
+        allocator.set_on_oom([&](const FreeListOpt::OutOfMemoryEvent& /*event*/) {
+            n_calls++;
+            return false;
+        });
+        REQUIRE(!allocator.allocate(1_KiB, FreeListOpt::AllocationHint{}).has_value());
+        REQUIRE(n_calls == 2);
+
+        allocator.set_on_oom(nullptr);
+        REQUIRE(!allocator.allocate(1_KiB).has_value());
+        REQUIRE(n_calls == 2);
+    }
+
+    SECTION("Fragmentation") {
+        for (size_t i = 0; i < allocations.size(); i += 2) {
+            allocator.deallocate(allocations[i]);
+        }
+        double external_fragmentation = 0;
+        allocator.set_on_oom([&](const FreeListOpt::OutOfMemoryEvent& event) {
+            external_fragmentation = event.external_fragmentation;
+            return false;
+        });
+        REQUIRE(!allocator.allocate(2_KiB).has_value());
+        REQUIRE(external_fragmentation == 1.0 - 1.0 / 8);
+    }
+
+    SECTION("Watermarks") {
+        for (auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+        allocations.clear();
+        std::vector<std::pair<FreeListOpt::Watermark, DeviceAddr>> events;
+        allocator.set_watermarks(4_KiB, 8_KiB, [&](FreeListOpt::Watermark watermark, DeviceAddr free_bytes) {
+            events.emplace_back(watermark, free_bytes);
+        });
+        REQUIRE(events.empty());
+        for (size_t i = 0; i < 14; i++) {
+            allocations.push_back(allocator.allocate(1_KiB).value());
+        }
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0] == std::make_pair(FreeListOpt::Watermark::LOW, 3_KiB));
+        for (size_t i = 0; i < 7; i++) {
+            allocator.deallocate(allocations.back());
+            allocations.pop_back();
+        }
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[1] == std::make_pair(FreeListOpt::Watermark::HIGH, 9_KiB));
+
+        // Already below the low watermark when registered
+        size_t n_low = 0;
+        allocator.set_watermarks(12_KiB, 12_KiB, [&](FreeListOpt::Watermark watermark, DeviceAddr /*free_bytes*/) {
+            n_low += watermark == FreeListOpt::Watermark::LOW;
+        });
+        REQUIRE(n_low == 1);
+        allocator.clear();
+        allocator.allocate(8_KiB);
+        REQUIRE(n_low == 2);
+    }
+}
+
+TEST_CASE("Validation") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    std::vector<FreeListOpt::Options> configs = {
+        {},
+        {.metadata_layout = FreeListOpt::MetadataLayout::COMPACT},
+        {.size_class_order = FreeListOpt::SizeClassOrder::SIZE},
+        {.size_class_base = 64, .size_class_subdivisions = 4},
+        {.quick_list_depth = 4},
+        {.search_policy = FreeListOpt::SearchPolicy::NEXT},
+    };
+    for (auto options : configs) {
+        // Validate after every operation from inside the allocator, and explicitly at the end
+        options.validate = true;
+        FreeListOpt allocator(4_MiB, 0, 32, 32, options);
+        REQUIRE_NOTHROW(allocator.validate());
+        std::mt19937 gen(42);
+        std::vector<DeviceAddr> allocations;
+        for (size_t i = 0; i < 5000; i++) {
+            int op = gen() % 10;
+            if (op < 5 || allocations.empty()) {
+                auto addr = allocator.allocate((gen() % 64 + 1) * 96, op % 2 == 0);
+                if (addr.has_value()) {
+                    allocations.push_back(*addr);
+                }
+            } else if (op < 6) {
+                DeviceAddr addr = gen() % 4_MiB / 32 * 32;
+                auto results = allocator.allocate_at_addresses({{addr, 1_KiB}, {addr + 4_KiB, 64}});
+                for (auto result : results) {
+                    if (result.has_value()) {
+                        allocations.push_back(*result);
+                    }
+                }
+            } else {
+                size_t index = gen() % allocations.size();
+                allocator.deallocate(allocations[index]);
+                allocations.erase(allocations.begin() + index);
+            }
+            if (i % 1000 == 0) {
+                allocator.compact_metadata();
+            }
+        }
+        REQUIRE_NOTHROW(allocator.validate());
+        for (auto addr : allocations) {
+            allocator.deallocate(addr);
+        }
+        allocator.shrink_size(64_KiB);
+        REQUIRE_NOTHROW(allocator.validate());
+        allocator.reset_size();
+        allocator.clear();
+        REQUIRE_NOTHROW(allocator.validate());
+    }
+}
+
+TEST_CASE("Structured dump") {
+    using tt::tt_metal::allocator::FreeListOpt;
+    FreeListOpt allocator(1_MiB, 64_KiB, 32, 32, {.quick_list_depth = 4});
+    auto a = allocator.allocate(1_KiB);
+    auto b = allocator.allocate(2_KiB);
+    auto c = allocator.allocate(128_KiB);
+    allocator.allocate(1_KiB);
+    allocator.deallocate(*b);  // parked on a quick list
+    allocator.deallocate(*c);  // too large to park
+
+    std::vector<FreeListOpt::BlockView> blocks;
+    allocator.for_each_block([&](const FreeListOpt::BlockView& block) { blocks.push_back(block); });
+    REQUIRE(blocks.size() == 5);
+    DeviceAddr address = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        REQUIRE(blocks[i].address == address);
+        REQUIRE(blocks[i].prev_block == (i == 0 ? -1 : ssize_t(blocks[i - 1].id)));
+        address += blocks[i].size;
+    }
+    REQUIRE(address == 1_MiB);
+    REQUIRE(blocks[0].address + 64_KiB == *a);
+    REQUIRE(blocks[1].address + 64_KiB == *b);
+    REQUIRE(blocks[2].address + 64_KiB == *c);
+    REQUIRE((blocks[1].is_allocated && blocks[1].in_quick_list));
+    REQUIRE((!blocks[2].is_allocated && !blocks[2].in_quick_list));
+
+    SECTION("Text") {
+        std::stringstream text, expected;
+        allocator.dump_blocks(text, FreeListOpt::DumpFormat::TEXT);
+        allocator.dump_blocks(expected);
+        REQUIRE(text.str() == expected.str());
+    }
+
+    SECTION("JSON") {
+        std::stringstream json;
+        allocator.dump_blocks(json, FreeListOpt::DumpFormat::JSON);
+        std::string str = json.str();
+        REQUIRE(str.front() == '{');
+        REQUIRE(str.substr(str.size() - 3) == "]}\n");
+        REQUIRE(str.find("\"offset_bytes\":65536") != std::string::npos);
+        REQUIRE(str.find("\"quick_lists\":[{\"size\":2048,\"blocks\":[") != std::string::npos);
+        REQUIRE(
+            str.find(fmt::format(
+                "{{\"id\":{},\"address\":1024,\"size\":2048,\"prev\":{},\"next\":{},\"state\":\"quick\"}}",
+                blocks[1].id,
+                blocks[1].prev_block,
+                blocks[1].next_block)) != std::string::npos);
+        size_t n_blocks = 0;
+        for (size_t pos = str.find("\"state\""); pos != std::string::npos; pos = str.find("\"state\"", pos + 1)) {
+            n_blocks++;
+        }
+        REQUIRE(n_blocks == blocks.size());
+    }
+
+    SECTION("Binary") {
+        std::stringstream binary;
+        allocator.dump_blocks(binary, FreeListOpt::DumpFormat::BINARY);
+        std::string str = binary.str();
+        size_t pos = 0;
+        auto get = [&](auto value) {
+            REQUIRE(pos + sizeof(value) <= str.size());
+            std::memcpy(&value, str.data() + pos, sizeof(value));
+            pos += sizeof(value);
+            return value;
+        };
+        REQUIRE(str.substr(0, 4) == "TTFL");
+        pos = 4;
+        REQUIRE(get(uint32_t{}) == 1);
+        REQUIRE(get(uint64_t{}) == 1_MiB);
+        REQUIRE(get(uint64_t{}) == 64_KiB);
+        REQUIRE(get(uint64_t{}) == 32);
+        REQUIRE(get(uint64_t{}) == 0);
+        auto stats = allocator.get_statistics();
+        REQUIRE(get(uint64_t{}) == stats.total_allocated_bytes);
+        REQUIRE(get(uint64_t{}) == stats.total_free_bytes);
+        REQUIRE(get(uint64_t{}) == stats.largest_free_block_bytes);
+
+        uint64_t n_size_classes = get(uint64_t{});
+        REQUIRE(n_size_classes == allocator.size_classes().size());
+        size_t n_free_blocks = 0;
+        for (size_t i = 0; i < n_size_classes; i++) {
+            REQUIRE(get(uint64_t{}) == allocator.size_classes()[i]);
+            uint64_t n = get(uint64_t{});
+            for (size_t j = 0; j < n; j++) {
+                get(uint64_t{});
+            }
+            n_free_blocks += n;
+        }
+        REQUIRE(n_free_blocks == 2);
+        REQUIRE(get(uint64_t{}) == 1);
+        REQUIRE(get(uint64_t{}) == 2_KiB);
+        REQUIRE(get(uint64_t{}) == 1);
+        REQUIRE(get(uint64_t{}) == blocks[1].id);
+        uint64_t n_unused_slots = get(uint64_t{});
+        pos += n_unused_slots * sizeof(uint64_t);
+
+        REQUIRE(get(uint64_t{}) == blocks.size());
+        for (const auto& block : blocks) {
+            REQUIRE(get(uint64_t{}) == block.id);
+            REQUIRE(get(uint64_t{}) == block.address);
+            REQUIRE(get(uint64_t{}) == block.size);
+            REQUIRE(get(int64_t{}) == block.prev_block);
+            REQUIRE(get(int64_t{}) == block.next_block);
+            REQUIRE(get(uint8_t{}) == (block.in_quick_list ? 2 : block.is_allocated ? 1 : 0));
+            pos += 7;
+        }
+        REQUIRE(pos == str.size());
+    }
+}
+
+TEST_CASE("FreeList matches the reference implementation") {
+    using tt::tt_metal::allocator::FreeList;
+    for (size_t seed = 0; seed < 8; seed++) {
+        require_same_as_reference_free_list(FreeList::SearchPolicy::BEST, 5000, seed);
+        require_same_as_reference_free_list(FreeList::SearchPolicy::FIRST, 5000, seed);
+    }
+}
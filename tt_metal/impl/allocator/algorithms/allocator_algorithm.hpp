@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <string>
 #include <vector>
 #include <iostream>
 using DeviceAddr = size_t;
@@ -30,12 +31,23 @@ using DeviceAddr = size_t;
     throw std::runtime_error(fmt::format(__VA_ARGS__));
 
 
+struct TenantStatistics {
+    uint32_t id = 0;
+    std::string name;
+    size_t quota_bytes = 0;
+    size_t allocated_bytes = 0;
+    size_t peak_allocated_bytes = 0;
+    size_t num_allocations = 0;     // live allocations
+    size_t num_quota_failures = 0;  // allocations refused for going over the quota
+};
+
 struct Statistics {
     size_t total_allocatable_size_bytes = 0;
     size_t total_allocated_bytes = 0;
     size_t total_free_bytes = 0;
     size_t largest_free_block_bytes = 0;
     std::vector<uint32_t> largest_free_block_addrs;  // addresses (relative to bank) that can hold the largest_free_block_bytes
+    std::vector<TenantStatistics> tenants;  // per tenant usage, for allocators that support tenants
 };
 
 
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+// Owns a FreeListOpt or a FreeList and calls it without going through Algorithm's vtable. Each call is a switch on the
+// held type followed by a direct call (both classes are final), so the compiler sees the concrete function and can
+// inline it. Code that only knows Algorithm keeps working through algorithm(). Construct with the allocator type and
+// its constructor arguments:
+//   AllocatorHandle handle(std::in_place_type<FreeListOpt>, size, offset, min_allocation_size, alignment);
+class AllocatorHandle {
+public:
+    template <typename Allocator, typename... Args>
+    explicit AllocatorHandle(std::in_place_type_t<Allocator> type, Args&&... args) :
+        allocator_(type, std::forward<Args>(args)...) {}
+
+    Algorithm& algorithm() {
+        return std::visit([](auto& allocator) -> Algorithm& { return allocator; }, allocator_);
+    }
+    const Algorithm& algorithm() const {
+        return std::visit([](const auto& allocator) -> const Algorithm& { return allocator; }, allocator_);
+    }
+    // The concrete allocator, or nullptr if the handle holds the other one
+    template <typename Allocator>
+    Allocator* get_if() {
+        return std::get_if<Allocator>(&allocator_);
+    }
+    // Call visitor with the concrete allocator
+    template <typename Visitor>
+    decltype(auto) visit(Visitor&& visitor) {
+        return std::visit(std::forward<Visitor>(visitor), allocator_);
+    }
+
+    DeviceAddr align(DeviceAddr address) const {
+        return std::visit([&](const auto& allocator) { return allocator.align(address); }, allocator_);
+    }
+    DeviceAddr max_size_bytes() const {
+        return std::visit([](const auto& allocator) { return allocator.max_size_bytes(); }, allocator_);
+    }
+    std::optional<DeviceAddr> lowest_occupied_address() const {
+        return std::visit([](const auto& allocator) { return allocator.lowest_occupied_address(); }, allocator_);
+    }
+
+    void init() {
+        std::visit([](auto& allocator) { allocator.init(); }, allocator_);
+    }
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> available_addresses(DeviceAddr size_bytes) const {
+        return std::visit([&](const auto& allocator) { return allocator.available_addresses(size_bytes); }, allocator_);
+    }
+    std::optional<DeviceAddr> allocate(DeviceAddr size_bytes, bool bottom_up = true, DeviceAddr address_limit = 0) {
+        return std::visit(
+            [&](auto& allocator) { return allocator.allocate(size_bytes, bottom_up, address_limit); },
+            allocator_);
+    }
+    std::optional<DeviceAddr> allocate_at_address(DeviceAddr absolute_start_address, DeviceAddr size_bytes) {
+        return std::visit(
+            [&](auto& allocator) { return allocator.allocate_at_address(absolute_start_address, size_bytes); },
+            allocator_);
+    }
+    void deallocate(DeviceAddr absolute_address) {
+        std::visit([&](auto& allocator) { allocator.deallocate(absolute_address); }, allocator_);
+    }
+    void clear() {
+        std::visit([](auto& allocator) { allocator.clear(); }, allocator_);
+    }
+    Statistics get_statistics() const {
+        return std::visit([](const auto& allocator) { return allocator.get_statistics(); }, allocator_);
+    }
+    void dump_blocks(std::ostream& out) const {
+        std::visit([&](const auto& allocator) { allocator.dump_blocks(out); }, allocator_);
+    }
+    void shrink_size(DeviceAddr shrink_size, bool bottom_up = true) {
+        std::visit([&](auto& allocator) { allocator.shrink_size(shrink_size, bottom_up); }, allocator_);
+    }
+    void reset_size() {
+        std::visit([](auto& allocator) { allocator.reset_size(); }, allocator_);
+    }
+    size_t metadata_memory_bytes() const {
+        return std::visit([](const auto& allocator) { return allocator.metadata_memory_bytes(); }, allocator_);
+    }
+
+private:
+    std::variant<FreeListOpt, FreeList> allocator_;
+};
+
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
@@ -3,7 +3,6 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "free_list.hpp"
-#include <boost/smart_ptr/make_local_shared.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -19,81 +18,89 @@ FreeList::FreeList(DeviceAddr max_size_bytes, DeviceAddr offset_bytes, DeviceAdd
     this->init();
 }
 
-FreeList::~FreeList() {
-    this->clear();
-}
-
 void FreeList::init() {
-    boost::local_shared_ptr<FreeList::Block> curr_block = this->block_head_;
-    while (curr_block != nullptr) {
-        auto next_block = curr_block->next_block;
-        curr_block->prev_block = nullptr;
-        curr_block->next_block = nullptr;
-        curr_block->prev_free = nullptr;
-        curr_block->next_free = nullptr;
-        curr_block = next_block;
-    }
+    this->blocks_.clear();
+    this->free_block_slots_.clear();
+    this->allocated_blocks_.clear();
 
     this->shrink_size_ = 0;
-    auto block = boost::make_local_shared<Block>(0, this->max_size_bytes_);
+    auto block = this->new_block(0, this->max_size_bytes_);
     this->block_head_ = block;
     this->block_tail_ = block;
     this->free_block_head_ = block;
     this->free_block_tail_ = block;
 }
 
-bool FreeList::is_allocated(const boost::local_shared_ptr<Block>& block) const {
-    return block->prev_free == nullptr and block->next_free == nullptr and block != this->free_block_head_ and block != this->free_block_tail_;
+FreeList::BlockIndex FreeList::new_block(DeviceAddr address, DeviceAddr size, BlockIndex prev_block, BlockIndex next_block, BlockIndex prev_free, BlockIndex next_free) {
+    Block block{.address = address, .size = size, .prev_block = prev_block, .next_block = next_block, .prev_free = prev_free, .next_free = next_free};
+    if (not this->free_block_slots_.empty()) {
+        BlockIndex index = this->free_block_slots_.back();
+        this->free_block_slots_.pop_back();
+        this->blocks_[index] = block;
+        return index;
+    }
+    this->blocks_.push_back(block);
+    return this->blocks_.size() - 1;
+}
+
+void FreeList::delete_block(BlockIndex block) {
+    this->free_block_slots_.push_back(block);
+}
+
+bool FreeList::is_allocated(BlockIndex block) const {
+    return this->blocks_[block].prev_free == no_block and this->blocks_[block].next_free == no_block and block != this->free_block_head_ and block != this->free_block_tail_;
 }
 
 std::vector<std::pair<DeviceAddr, DeviceAddr>> FreeList::available_addresses(DeviceAddr size_bytes) const {
     DeviceAddr alloc_size = size_bytes < this->min_allocation_size_ ? this->min_allocation_size_ : size_bytes;
     alloc_size = this->align(alloc_size);
     std::vector<std::pair<DeviceAddr, DeviceAddr>> addresses;
-    boost::local_shared_ptr<FreeList::Block> curr_block = this->free_block_head_;
-    while (curr_block != nullptr) {
-        if (curr_block->size >= alloc_size) {
-            DeviceAddr end_range = (curr_block->address + curr_block->size) - alloc_size;
-            addresses.push_back({curr_block->address, end_range});
+    BlockIndex curr_block = this->free_block_head_;
+    while (curr_block != no_block) {
+        const Block& block = this->blocks_[curr_block];
+        if (block.size >= alloc_size) {
+            DeviceAddr end_range = (block.address + block.size) - alloc_size;
+            addresses.push_back({block.address, end_range});
         }
-        curr_block = curr_block->next_free;
+        curr_block = block.next_free;
     }
     return addresses;
 }
 
-boost::local_shared_ptr<FreeList::Block> FreeList::search_best(DeviceAddr size_bytes, bool bottom_up) {
-    boost::local_shared_ptr<FreeList::Block> best_block = nullptr;
-    boost::local_shared_ptr<FreeList::Block> curr_block = bottom_up ? this->free_block_head_ : this->free_block_tail_;
-    while (curr_block != nullptr) {
-        if (curr_block->size == size_bytes) {
+FreeList::BlockIndex FreeList::search_best(DeviceAddr size_bytes, bool bottom_up) {
+    BlockIndex best_block = no_block;
+    BlockIndex curr_block = bottom_up ? this->free_block_head_ : this->free_block_tail_;
+    while (curr_block != no_block) {
+        const Block& block = this->blocks_[curr_block];
+        if (block.size == size_bytes) {
             best_block = curr_block;
             break;
-        } else if (curr_block->size >= size_bytes) {
-            if (best_block == nullptr or curr_block->size < best_block->size) {
+        } else if (block.size >= size_bytes) {
+            if (best_block == no_block or block.size < this->blocks_[best_block].size) {
                 best_block = curr_block;
             }
         }
-        curr_block = bottom_up ? curr_block->next_free : curr_block->prev_free;
+        curr_block = bottom_up ? block.next_free : block.prev_free;
     }
 
     return best_block;
 }
 
-boost::local_shared_ptr<FreeList::Block> FreeList::search_first(DeviceAddr size_bytes, bool bottom_up) {
-    boost::local_shared_ptr<FreeList::Block> curr_block = bottom_up ? this->free_block_head_ : this->free_block_tail_;
-    boost::local_shared_ptr<FreeList::Block> first_fit_block = nullptr;
-    while (curr_block != nullptr) {
-        if (curr_block->size >= size_bytes) {
+FreeList::BlockIndex FreeList::search_first(DeviceAddr size_bytes, bool bottom_up) {
+    BlockIndex curr_block = bottom_up ? this->free_block_head_ : this->free_block_tail_;
+    BlockIndex first_fit_block = no_block;
+    while (curr_block != no_block) {
+        if (this->blocks_[curr_block].size >= size_bytes) {
             first_fit_block = curr_block;
             break;
         }
-        curr_block = bottom_up ? curr_block->next_free : curr_block->prev_free;
+        curr_block = bottom_up ? this->blocks_[curr_block].next_free : this->blocks_[curr_block].prev_free;
     }
 
     return first_fit_block;
 }
 
-boost::local_shared_ptr<FreeList::Block> FreeList::search(DeviceAddr size_bytes, bool bottom_up) {
+FreeList::BlockIndex FreeList::search(DeviceAddr size_bytes, bool bottom_up) {
     switch (this->search_policy_) {
         case FreeList::SearchPolicy::BEST:
             return search_best(size_bytes, bottom_up);
@@ -105,87 +112,87 @@ boost::local_shared_ptr<FreeList::Block> FreeList::search(DeviceAddr size_bytes,
             // TT_ASSERT(false && "Unsupported search policy");
             abort();
     }
-    return nullptr;
+    return no_block;
 }
 
-void FreeList::allocate_entire_free_block(const boost::local_shared_ptr<Block>& free_block_to_allocate) {
+void FreeList::allocate_entire_free_block(BlockIndex free_block_to_allocate) {
     // TT_ASSERT(not is_allocated(free_block_to_allocate));
-    if (free_block_to_allocate->prev_free != nullptr) {
-        free_block_to_allocate->prev_free->next_free = free_block_to_allocate->next_free;
+    Block& block = this->blocks_[free_block_to_allocate];
+    if (block.prev_free != no_block) {
+        this->blocks_[block.prev_free].next_free = block.next_free;
     }
-    if (free_block_to_allocate->next_free != nullptr) {
-        free_block_to_allocate->next_free->prev_free = free_block_to_allocate->prev_free;
+    if (block.next_free != no_block) {
+        this->blocks_[block.next_free].prev_free = block.prev_free;
     }
     if (free_block_to_allocate == this->free_block_head_) {
-        if (free_block_to_allocate->next_free == nullptr) {
-            this->free_block_head_ = nullptr;
-        } else {
-            this->free_block_head_ = free_block_to_allocate->next_free;
-        }
+        this->free_block_head_ = block.next_free;
     }
     if (free_block_to_allocate == this->free_block_tail_) {
-        if (free_block_to_allocate->prev_free == nullptr) {
-            this->free_block_tail_ = nullptr;
-        } else {
-            this->free_block_tail_ = free_block_to_allocate->prev_free;
-        }
+        this->free_block_tail_ = block.prev_free;
     }
-    free_block_to_allocate->prev_free = nullptr;
-    free_block_to_allocate->next_free = nullptr;
+    block.prev_free = no_block;
+    block.next_free = no_block;
 }
 
 // free_block range: [a, b)
 // allocated_block range: [a, c), where c < b
-void FreeList::update_left_aligned_allocated_block_connections(const boost::local_shared_ptr<Block>& free_block, const boost::local_shared_ptr<Block>& allocated_block) {
-    allocated_block->prev_block = free_block->prev_block;
-    allocated_block->next_block = free_block;
-    if (free_block->prev_block != nullptr) {
-        free_block->prev_block->next_block = allocated_block;
+void FreeList::update_left_aligned_allocated_block_connections(BlockIndex free_block, BlockIndex allocated_block) {
+    Block& free = this->blocks_[free_block];
+    Block& allocated = this->blocks_[allocated_block];
+    allocated.prev_block = free.prev_block;
+    allocated.next_block = free_block;
+    if (free.prev_block != no_block) {
+        this->blocks_[free.prev_block].next_block = allocated_block;
     }
     if (free_block == this->block_head_) {
         this->block_head_ = allocated_block;
     }
     // next_free and prev_free connections of free_block are still valid
-    free_block->prev_block = allocated_block;
-    free_block->address = allocated_block->address + allocated_block->size;
-    free_block->size -= allocated_block->size;
+    free.prev_block = allocated_block;
+    free.address = allocated.address + allocated.size;
+    free.size -= allocated.size;
 }
 
 // free_block range: [a, b)
 // allocated_block range: [c, b), where c > a
-void FreeList::update_right_aligned_allocated_block_connections(const boost::local_shared_ptr<Block>& free_block, const boost::local_shared_ptr<Block>& allocated_block) {
-    allocated_block->prev_block = free_block;
-    allocated_block->next_block = free_block->next_block;
-    if (free_block->next_block != nullptr) {
-        free_block->next_block->prev_block = allocated_block;
+void FreeList::update_right_aligned_allocated_block_connections(BlockIndex free_block, BlockIndex allocated_block) {
+    Block& free = this->blocks_[free_block];
+    Block& allocated = this->blocks_[allocated_block];
+    allocated.prev_block = free_block;
+    allocated.next_block = free.next_block;
+    if (free.next_block != no_block) {
+        this->blocks_[free.next_block].prev_block = allocated_block;
     }
     if (free_block == this->block_tail_) {
         this->block_tail_ = allocated_block;
     }
     // next_free and prev_free connections of free_block are still valid
-    free_block->next_block = allocated_block;
-    free_block->size -= allocated_block->size;
+    free.next_block = allocated_block;
+    free.size -= allocated.size;
 }
 
 // Offset marks the start of the allocated block
-boost::local_shared_ptr<FreeList::Block> FreeList::allocate_slice_of_free_block(boost::local_shared_ptr<FreeList::Block> free_block, DeviceAddr offset, DeviceAddr size_bytes) {
-    // TT_ASSERT(free_block->address + offset + size_bytes <= free_block->address + free_block->size);
+FreeList::BlockIndex FreeList::allocate_slice_of_free_block(BlockIndex free_block, DeviceAddr offset, DeviceAddr size_bytes) {
+    // TT_ASSERT(blocks_[free_block].address + offset + size_bytes <= blocks_[free_block].address + blocks_[free_block].size);
 
     // Allocated slice spans the entire space of free_block
-    if (offset == 0 and size_bytes == free_block->size) {
+    if (offset == 0 and size_bytes == this->blocks_[free_block].size) {
         this->allocate_entire_free_block(free_block);
         return free_block;
     }
 
-    auto allocated_block = boost::make_local_shared<FreeList::Block>(free_block->address + offset, size_bytes);
+    // NOTE: new_block may grow the pool, so don't hold references to blocks across it
+    auto allocated_block = this->new_block(this->blocks_[free_block].address + offset, size_bytes);
+    const DeviceAddr free_block_address = this->blocks_[free_block].address;
+    const DeviceAddr free_block_size = this->blocks_[free_block].size;
 
     // Allocated slice takes up a portion of free_block, three cases to consider:
     // 1. allocated_block is left aligned with free_block with free space remaining on the right
     // 2. allocated_block is right aligned with free_block with free space remaining on the left
     // 3. allocated_block is in the middle of free_block with free space on left and right sides
-    bool case_one = offset == 0 and size_bytes < free_block->size;
-    bool case_two = offset > 0 and ((free_block->address + offset + size_bytes) == (free_block->address + free_block->size));
-    bool case_three = offset > 0 and ((free_block->address + offset + size_bytes) < (free_block->address + free_block->size));
+    bool case_one = offset == 0 and size_bytes < free_block_size;
+    bool case_two = offset > 0 and ((free_block_address + offset + size_bytes) == (free_block_address + free_block_size));
+    bool case_three = offset > 0 and ((free_block_address + offset + size_bytes) < (free_block_address + free_block_size));
     // TT_ASSERT((int)(case_one + case_two + case_three) == 1);
 
     if (case_one) {
@@ -196,21 +203,22 @@ boost::local_shared_ptr<FreeList::Block> FreeList::allocate_slice_of_free_block(
         // TT_ASSERT(case_three);
         // Original: | .................... free_block ....................|
         // Result:   | free_block_mod | allocated_block | next_free_block  |
-        DeviceAddr next_free_block_addr = free_block->address + offset + size_bytes;
-        DeviceAddr next_free_block_size = (free_block->address + free_block->size) - next_free_block_addr;
-        auto next_free_block = boost::make_local_shared<FreeList::Block>(
+        DeviceAddr next_free_block_addr = free_block_address + offset + size_bytes;
+        DeviceAddr next_free_block_size = (free_block_address + free_block_size) - next_free_block_addr;
+        auto next_free_block = this->new_block(
             next_free_block_addr,
             next_free_block_size,
             allocated_block,
-            free_block->next_block,
+            this->blocks_[free_block].next_block,
             free_block,
-            free_block->next_free
+            this->blocks_[free_block].next_free
         );
-        if (free_block->next_block != nullptr) {
-            free_block->next_block->prev_block = next_free_block;
+        Block& free = this->blocks_[free_block];
+        if (free.next_block != no_block) {
+            this->blocks_[free.next_block].prev_block = next_free_block;
         }
-        if (free_block->next_free != nullptr) {
-            free_block->next_free->prev_free = next_free_block;
+        if (free.next_free != no_block) {
+            this->blocks_[free.next_free].prev_free = next_free_block;
         }
         if (this->free_block_tail_ == free_block) {
             this->free_block_tail_ = next_free_block;
@@ -218,13 +226,13 @@ boost::local_shared_ptr<FreeList::Block> FreeList::allocate_slice_of_free_block(
         if (this->block_tail_ == free_block) {
             this->block_tail_ = next_free_block;
         }
-        free_block->next_free = next_free_block;
-        free_block->next_block = allocated_block;
+        free.next_free = next_free_block;
+        free.next_block = allocated_block;
 
-        allocated_block->prev_block = free_block;
-        allocated_block->next_block = next_free_block;
+        this->blocks_[allocated_block].prev_block = free_block;
+        this->blocks_[allocated_block].next_block = next_free_block;
 
-        free_block->size -= (allocated_block->size + next_free_block->size);
+        free.size -= (size_bytes + next_free_block_size);
     }
 
     return allocated_block;
@@ -243,102 +251,109 @@ std::optional<DeviceAddr> FreeList::allocate(DeviceAddr size_bytes, bool bottom_
     alloc_size = this->align(alloc_size);
     auto free_block = search(alloc_size, bottom_up);
 
-    if (free_block == nullptr) {
+    if (free_block == no_block) {
         return std::nullopt;
     }
 
     // offset denotes where allocation starts relative to free_block start
-    DeviceAddr offset = bottom_up ? 0 : (((free_block->address + free_block->size) - alloc_size) - free_block->address);
+    const Block& free = this->blocks_[free_block];
+    DeviceAddr offset = bottom_up ? 0 : (((free.address + free.size) - alloc_size) - free.address);
     auto allocated_block = allocate_slice_of_free_block(free_block, offset, alloc_size);
+    DeviceAddr allocated_address = this->blocks_[allocated_block].address;
+    this->allocated_blocks_[allocated_address] = allocated_block;
 
-    this->update_lowest_occupied_address(allocated_block->address);
-    if (allocated_block->address + this->offset_bytes_ < address_limit) {
-        TT_THROW("Out of Memory: Cannot allocate at an address below {}. Tried to allocate at {}", address_limit, allocated_block->address + this->offset_bytes_);
+    this->update_lowest_occupied_address(allocated_address);
+    if (allocated_address + this->offset_bytes_ < address_limit) {
+        TT_THROW("Out of Memory: Cannot allocate at an address below {}. Tried to allocate at {}", address_limit, allocated_address + this->offset_bytes_);
     }
-    return allocated_block->address + this->offset_bytes_;
+    return allocated_address + this->offset_bytes_;
 }
 
 std::optional<DeviceAddr> FreeList::allocate_at_address(DeviceAddr absolute_start_address, DeviceAddr size_bytes) {
     TT_ASSERT(absolute_start_address % this->alignment_ == 0, "Requested address {} should be {} B aligned", absolute_start_address, this->alignment_);
     auto start_address = absolute_start_address - this->offset_bytes_;
-    boost::local_shared_ptr<FreeList::Block> curr_block = this->free_block_head_;
+    BlockIndex curr_block = this->free_block_head_;
     DeviceAddr alloc_size = size_bytes < this->min_allocation_size_ ? this->min_allocation_size_ : size_bytes;
     alloc_size = this->align(alloc_size);
     // Look for a free block of size at least size_bytes that encompasses start_address
-    while (curr_block != nullptr) {
-        if (curr_block->size >= alloc_size) {
-            if (curr_block->address == start_address) {
-                allocate_slice_of_free_block(curr_block, /*offset=*/0, alloc_size);
+    BlockIndex allocated_block = no_block;
+    while (curr_block != no_block) {
+        const Block& block = this->blocks_[curr_block];
+        if (block.size >= alloc_size) {
+            if (block.address == start_address) {
+                allocated_block = allocate_slice_of_free_block(curr_block, /*offset=*/0, alloc_size);
                 break;
-            } else if ((start_address > curr_block->address) and ((start_address + alloc_size) <= (curr_block->address + curr_block->size))) {
-                DeviceAddr start_offset = start_address - curr_block->address;
-                allocate_slice_of_free_block(curr_block, start_offset, alloc_size);
+            } else if ((start_address > block.address) and ((start_address + alloc_size) <= (block.address + block.size))) {
+                DeviceAddr start_offset = start_address - block.address;
+                allocated_block = allocate_slice_of_free_block(curr_block, start_offset, alloc_size);
                 break;
             }
         }
-        curr_block = curr_block->next_free;
+        curr_block = block.next_free;
     }
 
-    if (curr_block == nullptr) {
+    if (curr_block == no_block) {
         return std::nullopt;
     }
+    this->allocated_blocks_[start_address] = allocated_block;
     this->update_lowest_occupied_address(start_address);
     return absolute_start_address;
 }
 
-boost::local_shared_ptr<FreeList::Block> FreeList::find_block(DeviceAddr address) {
-    boost::local_shared_ptr<Block> block = nullptr;
-    boost::local_shared_ptr<Block> curr_block = this->block_head_;
-    while (curr_block != nullptr) {
-        if (curr_block->address == address) {
-            return curr_block;
-        }
-        curr_block = curr_block->next_block;
+FreeList::BlockIndex FreeList::find_block(DeviceAddr address) {
+    auto it = this->allocated_blocks_.find(address);
+    if (it == this->allocated_blocks_.end()) {
+        return no_block;
     }
-    return block;
+    return it->second;
 }
 
 void FreeList::update_lowest_occupied_address() {
-    boost::local_shared_ptr<Block> block = this->block_head_;
-    while (block != nullptr) {
+    BlockIndex block = this->block_head_;
+    while (block != no_block) {
         if (this->is_allocated(block)) {
             break;
         }
-        block = block->next_block;
+        block = this->blocks_[block].next_block;
     }
-    if (block == nullptr) {
+    if (block == no_block) {
         this->lowest_occupied_address_ = std::nullopt;
     } else {
-        this->lowest_occupied_address_ = block->address;
+        this->lowest_occupied_address_ = this->blocks_[block].address;
     }
 }
 
 void FreeList::deallocate(DeviceAddr absolute_address) {
     DeviceAddr address = absolute_address - this->offset_bytes_;
-    boost::local_shared_ptr<Block> block_to_free = find_block(address);
-    if (block_to_free == nullptr or not this->is_allocated(block_to_free)) {
+    BlockIndex block_to_free = find_block(address);
+    if (block_to_free == no_block or not this->is_allocated(block_to_free)) {
         return;
     }
+    this->allocated_blocks_.erase(address);
 
-    auto prev = block_to_free->prev_block;
-    auto next = block_to_free->next_block;
+    auto prev = this->blocks_[block_to_free].prev_block;
+    auto next = this->blocks_[block_to_free].next_block;
 
     bool merged_prev = false;
     bool merged_next = false;
-    if (prev != nullptr and not is_allocated(prev)) {
-        prev->next_block = block_to_free->next_block;
-        if (block_to_free->next_block != nullptr) {
-            block_to_free->next_block->prev_block = prev;
+    if (prev != no_block and not is_allocated(prev)) {
+        Block& prev_block = this->blocks_[prev];
+        prev_block.next_block = this->blocks_[block_to_free].next_block;
+        if (this->blocks_[block_to_free].next_block != no_block) {
+            this->blocks_[this->blocks_[block_to_free].next_block].prev_block = prev;
         }
-        prev->size += block_to_free->size;
+        prev_block.size += this->blocks_[block_to_free].size;
+        this->delete_block(block_to_free);
         block_to_free = prev;
         merged_prev = true;
     }
 
-    if (next != nullptr and not is_allocated(next)) {
-        block_to_free->next_block = next->next_block;
-        if (next->next_block != nullptr) {
-            next->next_block->prev_block = block_to_free;
+    if (next != no_block and not is_allocated(next)) {
+        Block& block = this->blocks_[block_to_free];
+        const Block& next_block = this->blocks_[next];
+        block.next_block = next_block.next_block;
+        if (next_block.next_block != no_block) {
+            this->blocks_[next_block.next_block].prev_block = block_to_free;
         }
         if (next == this->free_block_head_) {
             this->free_block_head_ = block_to_free;
@@ -346,40 +361,42 @@ void FreeList::deallocate(DeviceAddr absolute_address) {
         if (next == this->free_block_tail_) {
             this->free_block_tail_ = block_to_free;
         }
-        block_to_free->next_free = next->next_free;
-        if (next->next_free != nullptr) {
-            next->next_free->prev_free = block_to_free;
+        block.next_free = next_block.next_free;
+        if (next_block.next_free != no_block) {
+            this->blocks_[next_block.next_free].prev_free = block_to_free;
         }
         if (not merged_prev) {
-            block_to_free->prev_free = next->prev_free;
-            if (next->prev_free != nullptr) {
-                next->prev_free->next_free = block_to_free;
+            block.prev_free = next_block.prev_free;
+            if (next_block.prev_free != no_block) {
+                this->blocks_[next_block.prev_free].next_free = block_to_free;
             }
         }
-        block_to_free->size += next->size;
+        block.size += next_block.size;
+        this->delete_block(next);
         merged_next = true;
     }
 
     if (not merged_prev and not merged_next) {
         // Find where to include deallocated block in free list
-        auto prev_free_block = block_to_free->prev_block;
-        while (prev_free_block != nullptr and is_allocated(prev_free_block)) {
-            prev_free_block = prev_free_block->prev_block;
+        Block& block = this->blocks_[block_to_free];
+        auto prev_free_block = block.prev_block;
+        while (prev_free_block != no_block and is_allocated(prev_free_block)) {
+            prev_free_block = this->blocks_[prev_free_block].prev_block;
         }
-        auto next_free_block = block_to_free->next_block;
-        while (next_free_block != nullptr and is_allocated(next_free_block)) {
-            next_free_block = next_free_block->next_block;
+        auto next_free_block = block.next_block;
+        while (next_free_block != no_block and is_allocated(next_free_block)) {
+            next_free_block = this->blocks_[next_free_block].next_block;
         }
-        block_to_free->prev_free = prev_free_block;
-        if (prev_free_block != nullptr) {
-            prev_free_block->next_free = block_to_free;
+        block.prev_free = prev_free_block;
+        if (prev_free_block != no_block) {
+            this->blocks_[prev_free_block].next_free = block_to_free;
         } else {
             this->free_block_head_ = block_to_free;
         }
 
-        block_to_free->next_free = next_free_block;
-        if (next_free_block != nullptr) {
-            next_free_block->prev_free = block_to_free;
+        block.next_free = next_free_block;
+        if (next_free_block != no_block) {
+            this->blocks_[next_free_block].prev_free = block_to_free;
         } else {
             this->free_block_tail_ = block_to_free;
         }
@@ -399,21 +416,24 @@ Statistics FreeList::get_statistics() const {
         .total_allocatable_size_bytes = this->max_size_bytes_,
         .total_allocated_bytes = 0,
         .total_free_bytes = 0,
-        .largest_free_block_bytes = 0
+        .largest_free_block_bytes = 0,
+        .largest_free_block_addrs = {},
+        .tenants = {}
     };
 
-    boost::local_shared_ptr<Block> curr_block = this->block_head_;
-    while (curr_block != nullptr) {
+    BlockIndex curr_block = this->block_head_;
+    while (curr_block != no_block) {
+        const Block& block = this->blocks_[curr_block];
         if (this->is_allocated(curr_block)) {
-            stats.total_allocated_bytes += curr_block->size;
+            stats.total_allocated_bytes += block.size;
         } else {
-            stats.total_free_bytes += curr_block->size;
-            if (curr_block->size >= stats.largest_free_block_bytes) {
-                stats.largest_free_block_bytes = curr_block->size;
-                stats.largest_free_block_addrs.push_back(curr_block->address + this->offset_bytes_);
+            stats.total_free_bytes += block.size;
+            if (block.size >= stats.largest_free_block_bytes) {
+                stats.largest_free_block_bytes = block.size;
+                stats.largest_free_block_addrs.push_back(block.address + this->offset_bytes_);
             }
         }
-        curr_block = curr_block->next_block;
+        curr_block = block.next_block;
     }
     if (stats.total_allocated_bytes == 0) {
         stats.total_free_bytes = this->max_size_bytes_;
@@ -422,19 +442,29 @@ Statistics FreeList::get_statistics() const {
     return stats;
 }
 
-void FreeList::dump_block(const boost::local_shared_ptr<Block>& block, std::ostream &out) const {
+size_t FreeList::metadata_memory_bytes() const {
+    size_t bytes = sizeof(*this);
+    bytes += this->blocks_.capacity() * sizeof(Block);
+    bytes += this->free_block_slots_.capacity() * sizeof(BlockIndex);
+    // Each map node holds the entry and a next pointer, plus a pointer per bucket
+    bytes += this->allocated_blocks_.size() * (sizeof(std::pair<DeviceAddr, BlockIndex>) + sizeof(void*));
+    bytes += this->allocated_blocks_.bucket_count() * sizeof(void*);
+    return bytes;
+}
+
+void FreeList::dump_block(BlockIndex block, std::ostream &out) const {
     auto alloc_status = this->is_allocated(block) ? "Y" : "N";
-    out << ",,," << (block->address + this->offset_bytes_)
-        << "," << (block->size)
+    out << ",,," << (this->blocks_[block].address + this->offset_bytes_)
+        << "," << (this->blocks_[block].size)
         << "," << alloc_status << "\n";
 }
 
 void FreeList::dump_blocks(std::ostream &out) const {
     out << ",,Blocks:,Address (B),Size (B),Allocated (Y/N)\n";
-    boost::local_shared_ptr<Block> curr_block = this->block_head_;
-    while (curr_block != nullptr) {
+    BlockIndex curr_block = this->block_head_;
+    while (curr_block != no_block) {
         this->dump_block(curr_block, out);
-        curr_block = curr_block->next_block;
+        curr_block = this->blocks_[curr_block].next_block;
     }
     out << "\n";
 }
@@ -462,25 +492,28 @@ void FreeList::shrink_size(DeviceAddr shrink_size, bool bottom_up) {
     // with size of at least shrink size
     // Case 1: There is a free block at head and its size is greater than shrink size,
     // so we just need to modify its attributes
-    TT_ASSERT(this->free_block_head_ != nullptr, "Free block head should not be null");
-    if (this->free_block_head_->size > shrink_size) {
-        TT_ASSERT(this->free_block_head_->address == 0, "Free block head should start at 0");
-        this->free_block_head_->address = shrink_size;
-        this->free_block_head_->size -= shrink_size;
+    TT_ASSERT(this->free_block_head_ != no_block, "Free block head should not be null");
+    Block& free_head = this->blocks_[this->free_block_head_];
+    if (free_head.size > shrink_size) {
+        TT_ASSERT(free_head.address == 0, "Free block head should start at 0");
+        free_head.address = shrink_size;
+        free_head.size -= shrink_size;
     }
     // Case 2: The free block at head is the exact shrink size, so we need to remove it
     else {
+        BlockIndex removed_block = this->free_block_head_;
         // Free block head is also the block head
-        this->block_head_ = this->block_head_->next_block;
-        this->block_head_->prev_block = nullptr;
+        this->block_head_ = this->blocks_[this->block_head_].next_block;
+        this->blocks_[this->block_head_].prev_block = no_block;
         // Free block head is also the free block tail when there is only 1 free block
-        if (this->free_block_head_->next_free == nullptr) {
-            this->free_block_tail_ = nullptr;
-            this->free_block_head_ = nullptr;
+        if (free_head.next_free == no_block) {
+            this->free_block_tail_ = no_block;
+            this->free_block_head_ = no_block;
         } else {
-            this->free_block_head_->next_free->prev_free = nullptr;
-            this->free_block_head_ = this->free_block_head_->next_free;
+            this->blocks_[free_head.next_free].prev_free = no_block;
+            this->free_block_head_ = free_head.next_free;
         }
+        this->delete_block(removed_block);
     }
     this->max_size_bytes_ -= shrink_size;
     this->shrink_size_ = shrink_size;
@@ -492,25 +525,25 @@ void FreeList::reset_size() {
     }
     // Case 1: No free blocks exist
     // We create a new free block which will be the free head and tail, and will also be our new block head
-    if (this->free_block_head_ == nullptr) {
-        this->free_block_head_ = boost::make_local_shared<FreeList::Block>(0, this->shrink_size_);
-        this->free_block_head_->next_block = this->block_head_;
+    if (this->free_block_head_ == no_block) {
+        this->free_block_head_ = this->new_block(0, this->shrink_size_);
+        this->blocks_[this->free_block_head_].next_block = this->block_head_;
         this->free_block_tail_ = this->free_block_head_;
         this->block_head_ = this->free_block_head_;
     }
     // Case 2: Free blocks exist but not at the start
-    else if (this->free_block_head_->address != this->shrink_size_) {
-        auto new_free_block = boost::make_local_shared<FreeList::Block>(0, this->shrink_size_);
-        new_free_block->next_block = this->block_head_;
-        new_free_block->next_free = this->free_block_head_;
-        this->free_block_head_->prev_free = new_free_block;
+    else if (this->blocks_[this->free_block_head_].address != this->shrink_size_) {
+        auto new_free_block = this->new_block(0, this->shrink_size_);
+        this->blocks_[new_free_block].next_block = this->block_head_;
+        this->blocks_[new_free_block].next_free = this->free_block_head_;
+        this->blocks_[this->free_block_head_].prev_free = new_free_block;
         this->free_block_head_ = new_free_block;
         this->block_head_ = this->free_block_head_;
     }
     // Case 3: There is a free block at the start and we just need to modify its attributes
     else {
-        this->free_block_head_->address = 0;
-        this->free_block_head_->size += this->shrink_size_;
+        this->blocks_[this->free_block_head_].address = 0;
+        this->blocks_[this->free_block_head_].size += this->shrink_size_;
     }
     this->max_size_bytes_ += this->shrink_size_;
     this->shrink_size_ = 0;
@@ -3,14 +3,14 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 #include <string>
+#include <unordered_map>
 
 #include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
-#include <boost/smart_ptr/local_shared_ptr.hpp>
 
 namespace tt {
 namespace tt_metal {
 namespace allocator {
-class FreeList : public Algorithm {
+class FreeList final : public Algorithm {
    public:
     enum class SearchPolicy {
         BEST = 0,
@@ -18,7 +18,6 @@ class FreeList : public Algorithm {
     };
 
     FreeList(DeviceAddr max_size_bytes, DeviceAddr offset_bytes, DeviceAddr min_allocation_size, DeviceAddr alignment, SearchPolicy search_policy);
-    ~FreeList();
     void init();
 
     std::vector<std::pair<DeviceAddr, DeviceAddr>> available_addresses(DeviceAddr size_bytes) const;
@@ -39,48 +38,60 @@ class FreeList : public Algorithm {
 
     void reset_size();
 
+    // Host memory used by the allocator's metadata, in bytes
+    size_t metadata_memory_bytes() const;
+
    private:
+    // Blocks live in a pool and link to each other by index into it, so splitting and merging blocks doesn't go
+    // through the heap and there is no reference counting. Slots of dead blocks are reused
+    using BlockIndex = ssize_t;
+    static constexpr BlockIndex no_block = -1;
     struct Block {
-        Block(DeviceAddr address, DeviceAddr size) : address(address), size(size) {}
-        Block(DeviceAddr address, DeviceAddr size, boost::local_shared_ptr<Block> prev_block, boost::local_shared_ptr<Block> next_block, boost::local_shared_ptr<Block> prev_free, boost::local_shared_ptr<Block> next_free)
-              : address(address), size(size), prev_block(prev_block), next_block(next_block), prev_free(prev_free), next_free(next_free) {}
         DeviceAddr address;
         DeviceAddr size;
-        boost::local_shared_ptr<Block> prev_block = nullptr;
-        boost::local_shared_ptr<Block> next_block = nullptr;
-        boost::local_shared_ptr<Block> prev_free = nullptr;
-        boost::local_shared_ptr<Block> next_free = nullptr;
+        BlockIndex prev_block = no_block;
+        BlockIndex next_block = no_block;
+        BlockIndex prev_free = no_block;
+        BlockIndex next_free = no_block;
     };
 
-    void dump_block(const boost::local_shared_ptr<Block>& block, std::ostream &out) const;
+    BlockIndex new_block(DeviceAddr address, DeviceAddr size, BlockIndex prev_block = no_block, BlockIndex next_block = no_block, BlockIndex prev_free = no_block, BlockIndex next_free = no_block);
+
+    void delete_block(BlockIndex block);
+
+    void dump_block(BlockIndex block, std::ostream &out) const;
 
-    bool is_allocated(const boost::local_shared_ptr<Block>& block) const;
+    bool is_allocated(BlockIndex block) const;
 
-    boost::local_shared_ptr<Block> search_best(DeviceAddr size_bytes, bool bottom_up);
+    BlockIndex search_best(DeviceAddr size_bytes, bool bottom_up);
 
-    boost::local_shared_ptr<Block> search_first(DeviceAddr size_bytes, bool bottom_up);
+    BlockIndex search_first(DeviceAddr size_bytes, bool bottom_up);
 
-    boost::local_shared_ptr<Block> search(DeviceAddr size_bytes, bool bottom_up);
+    BlockIndex search(DeviceAddr size_bytes, bool bottom_up);
 
-    void allocate_entire_free_block(const boost::local_shared_ptr<Block>& free_block_to_allocate);
+    void allocate_entire_free_block(BlockIndex free_block_to_allocate);
 
-    void update_left_aligned_allocated_block_connections(const boost::local_shared_ptr<Block>& free_block, const boost::local_shared_ptr<Block>& allocated_block);
+    void update_left_aligned_allocated_block_connections(BlockIndex free_block, BlockIndex allocated_block);
 
-    void update_right_aligned_allocated_block_connections(const boost::local_shared_ptr<Block>& free_block, const boost::local_shared_ptr<Block>& allocated_block);
+    void update_right_aligned_allocated_block_connections(BlockIndex free_block, BlockIndex allocated_block);
 
-    boost::local_shared_ptr<Block> allocate_slice_of_free_block(boost::local_shared_ptr<Block> free_block, DeviceAddr offset, DeviceAddr size_bytes);
+    BlockIndex allocate_slice_of_free_block(BlockIndex free_block, DeviceAddr offset, DeviceAddr size_bytes);
 
-    boost::local_shared_ptr<Block> find_block(DeviceAddr address);
+    BlockIndex find_block(DeviceAddr address);
 
     void update_lowest_occupied_address();
 
     void update_lowest_occupied_address(DeviceAddr address);
 
     SearchPolicy search_policy_;
-    boost::local_shared_ptr<Block> block_head_;
-    boost::local_shared_ptr<Block> block_tail_;
-    boost::local_shared_ptr<Block> free_block_head_;
-    boost::local_shared_ptr<Block> free_block_tail_;
+    std::vector<Block> blocks_;
+    std::vector<BlockIndex> free_block_slots_;
+    // Allocated blocks by address, so deallocation doesn't walk the block list
+    std::unordered_map<DeviceAddr, BlockIndex> allocated_blocks_;
+    BlockIndex block_head_ = no_block;
+    BlockIndex block_tail_ = no_block;
+    BlockIndex free_block_head_ = no_block;
+    BlockIndex free_block_tail_ = no_block;
 };
 
 }  // namespace allocator
@@ -1,12 +1,21 @@
 #include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
 #include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt_simd.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <optional>
 #include <vector>
 #include <array>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <fmt/compile.h>
+#include <fmt/format.h>
 
 inline size_t intlg2(size_t n) {
     // std::log2() is slow
@@ -23,10 +32,141 @@ inline size_t num_segerated_classes(size_t max_size_bytes, size_t size_segregate
     ssize_t count = intlg2(n);
     // 128MB as the last seggregated class size should be enough
     // avoid having too many classes as iterating them is not free
-    ssize_t max_count = intlg2(128 * 1024 * 1024 / size_segregated_base);
+    ssize_t max_count = std::max(ssize_t(intlg2(128 * 1024 * 1024 / size_segregated_base)), ssize_t{2});
     return std::clamp(count, ssize_t{2}, max_count);
 }
 
+// Lower bounds of each size class. Class i holds blocks in [bounds[i], bounds[i + 1]), the last class is unbounded
+inline std::vector<DeviceAddr> make_size_classes(
+    size_t max_size_bytes, DeviceAddr base, size_t subdivisions, const std::vector<DeviceAddr>& table) {
+    if (!table.empty()) {
+        TT_FATAL(table[0] == 0, "The first size class must start at 0, got {}", table[0]);
+        TT_FATAL(
+            std::adjacent_find(table.begin(), table.end(), std::greater_equal<DeviceAddr>()) == table.end(),
+            "Size class lower bounds must be strictly increasing");
+        return table;
+    }
+    TT_FATAL(base > 0, "Size class base must be greater than 0");
+    TT_FATAL(subdivisions > 0, "Size class subdivisions must be greater than 0");
+    std::vector<DeviceAddr> bounds;
+    size_t n_levels = num_segerated_classes(max_size_bytes, base);
+    for (size_t level = 0; level < n_levels; level++) {
+        // Level 0 covers [0, 2 * base), level n covers [base << n, base << (n + 1))
+        DeviceAddr start = level == 0 ? 0 : base << level;
+        DeviceAddr width = level == 0 ? 2 * base : base << level;
+        for (size_t i = 0; i < subdivisions; i++) {
+            DeviceAddr bound = start + width * i / subdivisions;
+            if (bounds.empty() || bound > bounds.back()) {
+                bounds.push_back(bound);
+            }
+        }
+    }
+    return bounds;
+}
+
+template <typename... Args>
+[[noreturn]] void validation_failure(fmt::format_string<Args...> format, Args&&... args) {
+    TT_THROW("FreeListOpt validation failed: {}", fmt::format(format, std::forward<Args>(args)...));
+}
+
+// Header of the blob written by FreeListOpt::serialize. Every section after it is an array padded to 8 bytes
+struct SerializedHeader {
+    char magic[4];  // "TTFS"
+    uint32_t version;
+    uint64_t size_bytes;  // of the whole blob
+    uint64_t checksum;    // of everything after this field
+    uint64_t flags;
+    uint64_t max_size_bytes;
+    uint64_t shrink_size;
+    uint64_t offset_bytes;
+    uint64_t min_allocation_size;
+    uint64_t alignment;
+    uint64_t allocated_bytes;
+    uint64_t quick_list_bytes;
+    uint64_t next_fit_rover;
+    uint64_t n_slots;
+    uint64_t n_unused_slots;
+    uint64_t n_size_classes;
+    uint64_t n_quick_lists;
+    uint64_t n_alloc_table_buckets;
+};
+static_assert(sizeof(SerializedHeader) % 8 == 0, "Sections after the header must stay 8 byte aligned");
+static_assert(sizeof(size_t) == 8 && sizeof(DeviceAddr) == 8, "The blob stores indices and addresses as 64 bit");
+constexpr uint32_t serialized_version = 1;
+constexpr uint64_t serialized_compact_layout = 1;
+constexpr uint64_t serialized_size_ordered_classes = 2;
+constexpr size_t serialized_checksum_start = offsetof(SerializedHeader, checksum) + sizeof(uint64_t);
+
+// Not cryptographic, only there to catch truncated or corrupted blobs. Four independent lanes so a large heap is
+// checksummed at about a word per cycle. size must be a multiple of 8
+inline uint64_t checksum_blob(const uint8_t* data, size_t size) {
+    uint64_t lanes[4] = {0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull};
+    auto mix = [](uint64_t lane, uint64_t word) {
+        lane = (lane ^ word) * 0xff51afd7ed558ccdull;
+        return lane ^ (lane >> 29);
+    };
+    size_t n_words = size / 8;
+    size_t i = 0;
+    for (; i + 4 <= n_words; i += 4) {
+        uint64_t words[4];
+        std::memcpy(words, data + i * 8, sizeof(words));
+        for (size_t lane = 0; lane < 4; lane++) {
+            lanes[lane] = mix(lanes[lane], words[lane]);
+        }
+    }
+    for (; i < n_words; i++) {
+        uint64_t word;
+        std::memcpy(&word, data + i * 8, sizeof(word));
+        lanes[i % 4] = mix(lanes[i % 4], word);
+    }
+    uint64_t hash = size;
+    for (uint64_t lane : lanes) {
+        hash = mix(hash, lane);
+    }
+    return hash;
+}
+
+class BlobWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        put_array(&value, 1);
+    }
+    template <typename T>
+    void put_array(const T* values, size_t n) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+        blob_.insert(blob_.end(), bytes, bytes + n * sizeof(T));
+        blob_.resize((blob_.size() + 7) / 8 * 8, 0);
+    }
+    std::vector<uint8_t>& blob() { return blob_; }
+
+private:
+    std::vector<uint8_t> blob_;
+};
+
+class BlobReader {
+public:
+    BlobReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    template <typename T>
+    void read_array(std::vector<T>& out, size_t n) {
+        if (n > (size_ - pos_) / sizeof(T)) {
+            TT_THROW(
+                "FreeListOpt blob is truncated: {} B section at {} past the end ({} B)", n * sizeof(T), pos_, size_);
+        }
+        out.resize(n);
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(out.data()), data_ + pos_, n * sizeof(T));
+        }
+        pos_ = std::min(size_, (pos_ + n * sizeof(T) + 7) / 8 * 8);
+    }
+    bool at_end() const { return pos_ == size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = sizeof(SerializedHeader);
+};
+
 namespace tt {
 
 namespace tt_metal {
@@ -35,20 +175,66 @@ namespace allocator {
 
 FreeListOpt::FreeListOpt(
     DeviceAddr max_size_bytes, DeviceAddr offset_bytes, DeviceAddr min_allocation_size, DeviceAddr alignment) :
-    size_segregated_count((num_segerated_classes(max_size_bytes, size_segregated_base))),
+    FreeListOpt(max_size_bytes, offset_bytes, min_allocation_size, alignment, Options{}) {}
+
+FreeListOpt::FreeListOpt(
+    DeviceAddr max_size_bytes,
+    DeviceAddr offset_bytes,
+    DeviceAddr min_allocation_size,
+    DeviceAddr alignment,
+    const Options& options) :
     Algorithm(max_size_bytes, offset_bytes, min_allocation_size, alignment) {
+    size_class_lower_bounds_ = make_size_classes(
+        max_size_bytes_, options.size_class_base, options.size_class_subdivisions, options.size_classes);
+    size_segregated_count = size_class_lower_bounds_.size();
+    power_of_two_size_classes_ = options.size_classes.empty() && options.size_class_subdivisions == 1 &&
+                                 (options.size_class_base & (options.size_class_base - 1)) == 0;
+    size_segregated_base_shift_ = intlg2(options.size_class_base) - 1;
+    power_of_two_alignment_ = alignment_ != 0 && (alignment_ & (alignment_ - 1)) == 0;
+    alignment_mask_ = power_of_two_alignment_ ? alignment_ - 1 : 0;
+    alignment_shift_ = power_of_two_alignment_ ? intlg2(alignment_) - 1 : 0;
+
+    // The compact layout stores addresses and sizes in units of the alignment in 31 bits
+    bool compact_fits = alignment_ != 0 && max_size_bytes_ % alignment_ == 0 &&
+                        max_size_bytes_ / alignment_ < DeviceAddr{compact_allocated_bit};
+    TT_FATAL(
+        options.metadata_layout != MetadataLayout::COMPACT || compact_fits,
+        "Bank of {} B with {} B alignment does not fit the compact metadata layout",
+        max_size_bytes_,
+        alignment_);
+    compact_layout_ = options.metadata_layout == MetadataLayout::COMPACT ||
+                      (options.metadata_layout == MetadataLayout::AUTO && compact_fits);
+    size_ordered_classes_ = options.size_class_order == SizeClassOrder::SIZE;
+    TT_FATAL(
+        options.search_policy == SearchPolicy::BEST || !size_ordered_classes_,
+        "Only the BEST search policy is supported with size ordered classes");
+    search_policy_ = options.search_policy;
+    good_enough_slack_ = options.good_enough_slack;
+    validate_after_each_operation_ = options.validate;
+    quick_list_depth_ = options.quick_list_depth;
+    quick_list_max_size_ = options.quick_list_max_size;
+    if (quick_list_depth_ != 0) {
+        quick_lists_.resize(n_quick_lists);
+    }
+
     // Reduce reallocations by reserving memory for free list components
     constexpr size_t initial_block_count = 64;
-    block_address_.reserve(initial_block_count);
-    block_size_.reserve(initial_block_count);
-    block_prev_block_.reserve(initial_block_count);
-    block_next_block_.reserve(initial_block_count);
-    block_is_allocated_.reserve(initial_block_count);
+    if (compact_layout_) {
+        compact_blocks_.reserve(initial_block_count);
+    } else {
+        block_address_.reserve(initial_block_count);
+        block_size_.reserve(initial_block_count);
+        block_prev_block_.reserve(initial_block_count);
+        block_next_block_.reserve(initial_block_count);
+        block_is_allocated_.reserve(initial_block_count);
+    }
     free_meta_block_indices_.reserve(initial_block_count);
     meta_block_is_allocated_.reserve(initial_block_count);
     free_blocks_segregated_by_size_.resize(size_segregated_count);
-    for (auto& free_blocks : free_blocks_segregated_by_size_) {
-        free_blocks.reserve(initial_block_count);
+    free_block_sizes_segregated_by_size_.resize(size_segregated_count);
+    for (size_t i = 0; i < size_segregated_count; i++) {
+        free_blocks_segregated_by_size_[i].reserve(initial_block_count);
+        free_block_sizes_segregated_by_size_[i].reserve(initial_block_count);
     }
     allocated_block_table_.resize(n_alloc_table_buckets);
     for (auto& bucket : allocated_block_table_) {
@@ -62,164 +248,476 @@ void FreeListOpt::init() {
     max_size_bytes_ += shrink_size_;
     shrink_size_ = 0;
 
-    block_address_.clear();
-    block_size_.clear();
-    block_prev_block_.clear();
-    block_next_block_.clear();
-    block_is_allocated_.clear();
+    clear_block_table();
     free_meta_block_indices_.clear();
-    meta_block_is_allocated_.clear();
     for (auto& bucket : allocated_block_table_) {
         bucket.clear();
     }
-    for (auto& free_blocks : free_blocks_segregated_by_size_) {
-        free_blocks.clear();
+    for (size_t i = 0; i < size_segregated_count; i++) {
+        free_blocks_segregated_by_size_[i].clear();
+        free_block_sizes_segregated_by_size_[i].clear();
     }
+    for (auto& quick_list : quick_lists_) {
+        quick_list.size = 0;
+        quick_list.blocks.clear();
+    }
+    quick_list_bytes_ = 0;
+    next_fit_rover_ = 0;
+    allocated_bytes_ = 0;
+    clear_tenant_allocations();
 
     // Create a single block that spans the entire memory
-    block_address_.push_back(0);
-    block_size_.push_back(max_size_bytes_);
-    block_prev_block_.push_back(-1);
-    block_next_block_.push_back(-1);
-    block_is_allocated_.push_back(false);
-    meta_block_is_allocated_.push_back(true);
-    free_blocks_segregated_by_size_[get_size_segregated_index(max_size_bytes_)].push_back(0);
+    push_block(0, max_size_bytes_, -1, -1, false);
+    insert_block_to_segregated_list(0);
+    maybe_validate();
+    check_watermarks();
+}
+
+template <typename Retry>
+std::optional<DeviceAddr> FreeListOpt::handle_oom(DeviceAddr size_bytes, DeviceAddr alloc_size, Retry&& retry) {
+    if (!on_oom_ || in_on_oom_) {
+        return std::nullopt;
+    }
+    Statistics statistics = get_statistics();
+    double external_fragmentation =
+        statistics.total_free_bytes == 0
+            ? 0.0
+            : 1.0 - double(statistics.largest_free_block_bytes) / double(statistics.total_free_bytes);
+    // Reset even if the callback throws. The callback is copied as it may replace itself
+    struct InOnOomGuard {
+        bool& in_on_oom;
+        ~InOnOomGuard() { in_on_oom = false; }
+    } guard{in_on_oom_};
+    in_on_oom_ = true;
+    OutOfMemoryCallback on_oom = on_oom_;
+    if (!on_oom(OutOfMemoryEvent{
+            .size_bytes = size_bytes,
+            .alloc_size = alloc_size,
+            .statistics = std::move(statistics),
+            .external_fragmentation = external_fragmentation,
+        })) {
+        return std::nullopt;
+    }
+    return retry();
 }
 
 std::optional<DeviceAddr> FreeListOpt::allocate(DeviceAddr size_bytes, bool bottom_up, DeviceAddr address_limit) {
-    DeviceAddr alloc_size = align(std::max(size_bytes, min_allocation_size_));
+    DeviceAddr alloc_size = get_alloc_size(size_bytes);
+
+    if (quick_list_depth_ != 0) {
+        auto addr = allocate_from_quick_list(alloc_size, address_limit);
+        if (addr.has_value()) {
+            return addr;
+        }
+    }
+
+    auto position = find_free_block(alloc_size, bottom_up, std::nullopt);
+    if (!position.has_value() && quick_list_bytes_ != 0) {
+        flush_quick_lists();
+        position = find_free_block(alloc_size, bottom_up, std::nullopt);
+    }
+    if (!position.has_value()) {
+        return handle_oom(size_bytes, alloc_size, [&] { return allocate(size_bytes, bottom_up, address_limit); });
+    }
+
+    size_t target_block_index = free_blocks_segregated_by_size_[position->size_class][position->index];
+    size_t offset = 0;
+    if (!bottom_up) {
+        offset = block_size(target_block_index) - alloc_size;
+    }
+    return allocate_from_free_block(*position, alloc_size, offset, address_limit);
+}
+
+std::optional<DeviceAddr> FreeListOpt::allocate(
+    DeviceAddr size_bytes, const AllocationHint& hint, DeviceAddr address_limit) {
+    DeviceAddr alloc_size = get_alloc_size(size_bytes);
+    bool bottom_up = hint.lifetime == Lifetime::LONG;
+    std::optional<DeviceAddr> affinity_address;
+    if (hint.affinity_address.has_value() && *hint.affinity_address >= offset_bytes_) {
+        affinity_address = *hint.affinity_address - offset_bytes_;
+    }
 
+    // Quick lists ignore placement, so hinted allocations only fall back to them by flushing
+    auto position = find_free_block(alloc_size, bottom_up, affinity_address);
+    if (!position.has_value() && quick_list_bytes_ != 0) {
+        flush_quick_lists();
+        position = find_free_block(alloc_size, bottom_up, affinity_address);
+    }
+    if (!position.has_value()) {
+        return handle_oom(size_bytes, alloc_size, [&] { return allocate(size_bytes, hint, address_limit); });
+    }
+
+    size_t target_block_index = free_blocks_segregated_by_size_[position->size_class][position->index];
+    DeviceAddr block_start = block_address(target_block_index);
+    DeviceAddr block_end = block_start + block_size(target_block_index);
+    // Allocate at the end of the block facing the affinity address. Else follow the lifetime
+    bool at_start = bottom_up;
+    if (affinity_address.has_value()) {
+        if (*affinity_address < block_start) {
+            at_start = true;
+        } else if (*affinity_address >= block_end) {
+            at_start = false;
+        } else {
+            at_start = *affinity_address - block_start < block_end - *affinity_address;
+        }
+    }
+    size_t offset = at_start ? 0 : block_size(target_block_index) - alloc_size;
+    return allocate_from_free_block(*position, alloc_size, offset, address_limit);
+}
+
+std::optional<FreeListOpt::SegregatedListPosition> FreeListOpt::find_free_block(
+    DeviceAddr alloc_size, bool bottom_up, std::optional<DeviceAddr> affinity_address) const {
     // Find the best free block by looking at the segregated free blocks, if we can find a block in it's size class
-    // we can be confident that it's the best block to allocate from. Else, look at the next size class. However the
-    // blocks within a size class are not sorted by size, so we may not always find the best block.
+    // we can be confident that it's the best block to allocate from. Else, look at the next size class. The sizes of
+    // the blocks in each class are mirrored in a contiguous array so the scan doesn't chase indices and can use SIMD
 
     ssize_t target_block_index = -1;
     size_t size_segregated_index = get_size_segregated_index(alloc_size);
     TT_ASSERT(size_segregated_index < size_segregated_count, "Size segregated index out of bounds");
-    std::vector<size_t>* segregated_list = nullptr;
-    size_t segregated_item_index = 0;
+    SegregatedListPosition position{0, 0};
 
-    for (size_t i = size_segregated_index; i < free_blocks_segregated_by_size_.size(); i++) {
-        auto& free_blocks = free_blocks_segregated_by_size_[i];
-        ssize_t increment = bottom_up ? 1 : -1;
-        for (ssize_t j = bottom_up ? 0 : free_blocks.size() - 1; j >= 0 && j < free_blocks.size(); j += increment) {
-            size_t block_index = free_blocks[j];
-            if (block_size_[block_index] == alloc_size) {
-                target_block_index = block_index;
-                segregated_list = &free_blocks;
-                segregated_item_index = j;
+    if (affinity_address.has_value()) {
+        // Blocks in the same size class are close enough in size that fit matters less than locality
+        const DeviceAddr affinity = *affinity_address;
+        DeviceAddr best_distance = 0;
+        for (size_t i = size_segregated_index; i < free_blocks_segregated_by_size_.size(); i++) {
+            const auto& free_blocks = free_blocks_segregated_by_size_[i];
+            const auto& free_block_sizes = free_block_sizes_segregated_by_size_[i];
+            for (size_t j = 0; j < free_blocks.size(); j++) {
+                size_t block_index = free_blocks[j];
+                if (free_block_sizes[j] < alloc_size) {
+                    continue;
+                }
+                DeviceAddr block_start = block_address(block_index);
+                DeviceAddr block_end = block_start + block_size(block_index);
+                DeviceAddr distance = 0;
+                if (affinity < block_start) {
+                    distance = block_start - affinity;
+                } else if (affinity >= block_end) {
+                    distance = affinity - block_end;
+                }
+                if (target_block_index == -1 || distance < best_distance ||
+                    (distance == best_distance && block_size(block_index) < block_size(target_block_index))) {
+                    target_block_index = block_index;
+                    best_distance = distance;
+                    position = {i, j};
+                }
+            }
+            if (target_block_index != -1) {
+                return position;
+            }
+        }
+        return std::nullopt;
+    }
+
+    if (size_ordered_classes_) {
+        // The first block not smaller than the request is the tightest fit. Among blocks of that size take the lowest
+        // address when allocating bottom up and the highest otherwise, same as the address ordered scan would
+        for (size_t i = size_segregated_index; i < free_block_sizes_segregated_by_size_.size(); i++) {
+            const auto& free_block_sizes = free_block_sizes_segregated_by_size_[i];
+            auto it = std::lower_bound(free_block_sizes.begin(), free_block_sizes.end(), alloc_size);
+            if (it == free_block_sizes.end()) {
+                continue;
+            }
+            if (!bottom_up) {
+                it = std::upper_bound(it, free_block_sizes.end(), *it) - 1;
+            }
+            return SegregatedListPosition{i, size_t(it - free_block_sizes.begin())};
+        }
+        return std::nullopt;
+    }
+
+    for (size_t i = size_segregated_index; i < free_block_sizes_segregated_by_size_.size(); i++) {
+        const auto& free_block_sizes = free_block_sizes_segregated_by_size_[i];
+        ssize_t j = -1;
+        switch (search_policy_) {
+            case SearchPolicy::BEST:
+                j = simd::find_best_fit(free_block_sizes.data(), free_block_sizes.size(), alloc_size, bottom_up);
                 break;
-            } else if (
-                block_size_[block_index] >= alloc_size &&
-                (target_block_index == -1 || block_size_[block_index] < block_size_[target_block_index])) {
-                target_block_index = block_index;
-                segregated_list = &free_blocks;
-                segregated_item_index = j;
+            case SearchPolicy::FIRST: j = find_first_fit(i, alloc_size, bottom_up); break;
+            case SearchPolicy::NEXT: j = find_next_fit(i, alloc_size); break;
+            case SearchPolicy::GOOD_ENOUGH: j = find_good_enough_fit(i, alloc_size, bottom_up); break;
+        }
+        if (j != -1) {
+            return SegregatedListPosition{i, size_t(j)};
+        }
+    }
+    return std::nullopt;
+}
+
+ssize_t FreeListOpt::find_first_fit(size_t size_class, DeviceAddr alloc_size, bool bottom_up) const {
+    const auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_class];
+    const ssize_t n = free_block_sizes.size();
+    if (bottom_up) {
+        for (ssize_t j = 0; j < n; j++) {
+            if (free_block_sizes[j] >= alloc_size) {
+                return j;
             }
         }
-        if (target_block_index != -1) {
-            break;
+    } else {
+        for (ssize_t j = n - 1; j >= 0; j--) {
+            if (free_block_sizes[j] >= alloc_size) {
+                return j;
+            }
         }
     }
+    return -1;
+}
 
-    if (target_block_index == -1) {
-        return std::nullopt;
+ssize_t FreeListOpt::find_next_fit(size_t size_class, DeviceAddr alloc_size) const {
+    const auto& free_blocks = free_blocks_segregated_by_size_[size_class];
+    const auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_class];
+    // The class is address ordered, so the blocks past the rover start at a binary searchable position
+    const size_t n = free_blocks.size();
+    const size_t start =
+        std::partition_point(
+            free_blocks.begin(), free_blocks.end(), [this](size_t block_index) {
+                return block_address(block_index) < next_fit_rover_;
+            }) -
+        free_blocks.begin();
+    for (size_t k = 0; k < n; k++) {
+        size_t j = start + k < n ? start + k : start + k - n;
+        if (free_block_sizes[j] >= alloc_size) {
+            return j;
+        }
     }
-    TT_ASSERT(segregated_list != nullptr, "Segregated list is null");
-    TT_ASSERT(segregated_item_index < segregated_list->size(), "Segregated item index out of bounds");
-    TT_ASSERT(
-        block_is_allocated_[target_block_index] == false, "Block we are trying allocate from is already allocated");
-    segregated_list->erase(segregated_list->begin() + segregated_item_index);
+    return -1;
+}
 
-    // Allocate the block
-    size_t offset = 0;
-    if (!bottom_up) {
-        offset = block_size_[target_block_index] - alloc_size;
+ssize_t FreeListOpt::find_good_enough_fit(size_t size_class, DeviceAddr alloc_size, bool bottom_up) const {
+    const auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_class];
+    const ssize_t n = free_block_sizes.size();
+    const DeviceAddr good_enough_size = alloc_size + DeviceAddr(alloc_size * good_enough_slack_);
+    ssize_t best = -1;
+    for (ssize_t k = 0; k < n; k++) {
+        ssize_t j = bottom_up ? k : n - 1 - k;
+        DeviceAddr size = free_block_sizes[j];
+        if (size < alloc_size) {
+            continue;
+        }
+        if (size <= good_enough_size) {
+            return j;
+        }
+        if (best == -1 || size < free_block_sizes[best]) {
+            best = j;
+        }
     }
+    return best;
+}
+
+DeviceAddr FreeListOpt::allocate_from_free_block(
+    SegregatedListPosition position, DeviceAddr alloc_size, size_t offset, DeviceAddr address_limit) {
+    TT_ASSERT(
+        position.index < free_blocks_segregated_by_size_[position.size_class].size(),
+        "Segregated item index out of bounds");
+    size_t target_block_index = free_blocks_segregated_by_size_[position.size_class][position.index];
+    TT_ASSERT(
+        block_is_allocated(target_block_index) == false, "Block we are trying allocate from is already allocated");
+    erase_from_segregated_list(position);
+
     size_t allocated_block_index = allocate_in_block(target_block_index, alloc_size, offset);
-    DeviceAddr start_address = block_address_[allocated_block_index];
+    DeviceAddr start_address = block_address(allocated_block_index);
+    next_fit_rover_ = start_address + alloc_size;
+    maybe_validate();
     if (start_address + offset_bytes_ < address_limit) {
         TT_THROW(
             "Out of Memory: Cannot allocate at an address below {}. Allocation at {}",
             address_limit,
             start_address + offset_bytes_);
     }
+    check_watermarks();
     return start_address + offset_bytes_;
 }
 
 std::optional<DeviceAddr> FreeListOpt::allocate_at_address(DeviceAddr absolute_start_address, DeviceAddr size_bytes) {
+    flush_quick_lists();
     // Nothing we can do but scan the free list
-    size_t alloc_size = align(std::max(size_bytes, min_allocation_size_));
+    size_t alloc_size = get_alloc_size(size_bytes);
     ssize_t target_block_index = -1;
     DeviceAddr start_address = absolute_start_address - offset_bytes_;
-    for (size_t i = 0; i < block_address_.size(); i++) {
-        size_t block_start = block_address_[i];
-        size_t block_end = block_start + block_size_[i];
+    TT_FATAL(
+        !compact_layout_ || start_address % alignment_ == 0,
+        "Requested address {} should be {} B aligned with the compact metadata layout",
+        absolute_start_address,
+        alignment_);
+    for (size_t i = 0; i < block_table_size(); i++) {
+        if (!meta_block_is_allocated_[i]) {
+            continue;
+        }
+        size_t block_start = block_address(i);
+        size_t block_end = block_start + block_size(i);
         if (start_address >= block_start && start_address + alloc_size <= block_end) {
             target_block_index = i;
             break;
         }
     }
 
-    if (target_block_index == -1 || block_is_allocated_[target_block_index]) {
+    if (target_block_index == -1 || block_is_allocated(target_block_index)) {
         return std::nullopt;
     }
 
-    // Find the relevant size segregated list
-    size_t size_segregated_index = get_size_segregated_index(block_size_[target_block_index]);
-    std::vector<size_t>& segregated_list = free_blocks_segregated_by_size_[size_segregated_index];
-    auto it = std::find(segregated_list.begin(), segregated_list.end(), target_block_index);
-    TT_ASSERT(it != segregated_list.end(), "Block not found in size segregated list");
-    segregated_list.erase(it);
+    remove_block_from_segregated_list(target_block_index);
 
-    size_t offset = start_address - block_address_[target_block_index];
+    size_t offset = start_address - block_address(target_block_index);
     size_t alloc_block_index = allocate_in_block(target_block_index, alloc_size, offset);
+    maybe_validate();
+    check_watermarks();
     return absolute_start_address;
 }
 
-size_t FreeListOpt::allocate_in_block(size_t block_index, DeviceAddr alloc_size, size_t offset) {
-    if (block_size_[block_index] == alloc_size && offset == 0) {
-        block_is_allocated_[block_index] = true;
-        insert_block_to_alloc_table(block_address_[block_index], block_index);
+std::vector<std::optional<DeviceAddr>> FreeListOpt::allocate_at_addresses(
+    const std::vector<std::pair<DeviceAddr, DeviceAddr>>& requests) {
+    flush_quick_lists();
+    std::vector<std::optional<DeviceAddr>> results(requests.size());
+    std::vector<size_t> order(requests.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    // Stable so that of requests at the same address the earlier one is tried first and wins
+    std::stable_sort(order.begin(), order.end(), [&requests](size_t a, size_t b) {
+        return requests[a].first < requests[b].first;
+    });
+
+    // Sweep the block list and the sorted requests together. The segregated lists are left stale while sweeping and
+    // rebuilt in one go at the end, so splitting blocks costs O(1) each
+    ssize_t block_index = find_head_block();
+    bool any_allocated = false;
+    for (size_t request_index : order) {
+        const auto [absolute_start_address, size_bytes] = requests[request_index];
+        if (absolute_start_address < offset_bytes_) {
+            continue;
+        }
+        DeviceAddr start_address = absolute_start_address - offset_bytes_;
+        DeviceAddr alloc_size = get_alloc_size(size_bytes);
+        TT_FATAL(
+            !compact_layout_ || start_address % alignment_ == 0,
+            "Requested address {} should be {} B aligned with the compact metadata layout",
+            absolute_start_address,
+            alignment_);
+        while (block_index != -1 && block_address(block_index) + block_size(block_index) <= start_address) {
+            block_index = block_next_block(block_index);
+        }
+        if (block_index == -1) {
+            break;
+        }
+        if (block_is_allocated(block_index) || start_address < block_address(block_index) ||
+            start_address + alloc_size > block_address(block_index) + block_size(block_index)) {
+            continue;
+        }
+        size_t offset = start_address - block_address(block_index);
+        block_index = allocate_in_block(block_index, alloc_size, offset, false);
+        results[request_index] = absolute_start_address;
+        any_allocated = true;
+    }
+
+    if (any_allocated) {
+        rebuild_segregated_lists();
+        maybe_validate();
+        check_watermarks();
+    }
+    return results;
+}
+
+size_t FreeListOpt::find_head_block() const {
+    for (size_t i = 0; i < block_table_size(); i++) {
+        if (meta_block_is_allocated_[i] && block_prev_block(i) == -1) {
+            return i;
+        }
+    }
+    TT_THROW("No head block found. This must be a bug");
+}
+
+size_t FreeListOpt::find_tail_block() const {
+    for (size_t i = 0; i < block_table_size(); i++) {
+        if (meta_block_is_allocated_[i] && block_next_block(i) == -1) {
+            return i;
+        }
+    }
+    TT_THROW("No tail block found. This must be a bug");
+}
+
+void FreeListOpt::rebuild_segregated_lists() {
+    for (size_t i = 0; i < size_segregated_count; i++) {
+        free_blocks_segregated_by_size_[i].clear();
+        free_block_sizes_segregated_by_size_[i].clear();
+    }
+    // Walking in address order keeps each list sorted by address without sorting
+    for (ssize_t i = find_head_block(); i != -1; i = block_next_block(i)) {
+        if (!block_is_allocated(i)) {
+            size_t size_segregated_index = get_size_segregated_index(block_size(i));
+            free_blocks_segregated_by_size_[size_segregated_index].push_back(i);
+            free_block_sizes_segregated_by_size_[size_segregated_index].push_back(block_size(i));
+        }
+    }
+    if (size_ordered_classes_) {
+        // Already in address order, a stable sort by size gives (size, address) order
+        std::vector<std::pair<DeviceAddr, size_t>> sorted_blocks;
+        for (size_t i = 0; i < size_segregated_count; i++) {
+            auto& free_blocks = free_blocks_segregated_by_size_[i];
+            auto& free_block_sizes = free_block_sizes_segregated_by_size_[i];
+            sorted_blocks.clear();
+            for (size_t j = 0; j < free_blocks.size(); j++) {
+                sorted_blocks.emplace_back(free_block_sizes[j], free_blocks[j]);
+            }
+            std::stable_sort(sorted_blocks.begin(), sorted_blocks.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+            for (size_t j = 0; j < sorted_blocks.size(); j++) {
+                free_block_sizes[j] = sorted_blocks[j].first;
+                free_blocks[j] = sorted_blocks[j].second;
+            }
+        }
+    }
+}
+
+size_t FreeListOpt::allocate_in_block(size_t block_index, DeviceAddr alloc_size, size_t offset, bool update_segregated_list) {
+    allocated_bytes_ += alloc_size;
+    if (block_size(block_index) == alloc_size && offset == 0) {
+        set_block_is_allocated(block_index, true);
+        insert_block_to_alloc_table(block_address(block_index), block_index);
         return block_index;
     }
 
     bool left_aligned = offset == 0;
-    bool right_aligned = offset + alloc_size == block_size_[block_index];
+    bool right_aligned = offset + alloc_size == block_size(block_index);
 
     // Create free space if not left/right aligned
     if (!left_aligned) {
         size_t free_block_size = offset;
-        DeviceAddr free_block_address = block_address_[block_index];
-        ssize_t prev_block = block_prev_block_[block_index];
-        ssize_t next_block = block_next_block_[block_index];
-        block_size_[block_index] -= offset;
-        block_address_[block_index] += offset;
+        DeviceAddr free_block_address = block_address(block_index);
+        ssize_t prev_block = block_prev_block(block_index);
+        ssize_t next_block = block_next_block(block_index);
+        set_block_size(block_index, block_size(block_index) - offset);
+        set_block_address(block_index, block_address(block_index) + offset);
         size_t new_block_index = alloc_meta_block(free_block_address, free_block_size, prev_block, block_index, false);
         if (prev_block != -1) {
-            block_next_block_[prev_block] = new_block_index;
+            set_block_next_block(prev_block, new_block_index);
         }
-        block_prev_block_[block_index] = new_block_index;
+        set_block_prev_block(block_index, new_block_index);
 
-        insert_block_to_segregated_list(new_block_index);
+        if (update_segregated_list) {
+            insert_block_to_segregated_list(new_block_index);
+        }
     }
 
     if (!right_aligned) {
-        size_t free_block_size = block_size_[block_index] - alloc_size;
-        DeviceAddr free_block_address = block_address_[block_index] + alloc_size;
+        size_t free_block_size = block_size(block_index) - alloc_size;
+        DeviceAddr free_block_address = block_address(block_index) + alloc_size;
         ssize_t prev_block = block_index;
-        ssize_t next_block = block_next_block_[block_index];
-        block_size_[block_index] -= free_block_size;
+        ssize_t next_block = block_next_block(block_index);
+        set_block_size(block_index, block_size(block_index) - free_block_size);
         size_t new_block_index = alloc_meta_block(free_block_address, free_block_size, prev_block, next_block, false);
         if (next_block != -1) {
-            block_prev_block_[next_block] = new_block_index;
+            set_block_prev_block(next_block, new_block_index);
         }
-        block_next_block_[block_index] = new_block_index;
+        set_block_next_block(block_index, new_block_index);
 
-        insert_block_to_segregated_list(new_block_index);
+        if (update_segregated_list) {
+            insert_block_to_segregated_list(new_block_index);
+        }
     }
-    block_is_allocated_[block_index] = true;
-    insert_block_to_alloc_table(block_address_[block_index], block_index);
+    set_block_is_allocated(block_index, true);
+    insert_block_to_alloc_table(block_address(block_index), block_index);
 
     return block_index;
 }
@@ -234,49 +732,44 @@ void FreeListOpt::deallocate(DeviceAddr absolute_address) {
         return;
     }
     size_t block_index = *block_index_opt;
-    block_is_allocated_[block_index] = false;
-    ssize_t prev_block = block_prev_block_[block_index];
-    ssize_t next_block = block_next_block_[block_index];
+    allocated_bytes_ -= block_size(block_index);
+    if (!tenant_allocations_.empty()) {
+        release_tenant_allocation(absolute_address, block_size(block_index));
+    }
+    if (quick_list_depth_ == 0 || !push_to_quick_list(block_index)) {
+        free_block(block_index);
+    }
+    maybe_compact_metadata();
+    maybe_validate();
+    check_watermarks();
+}
+
+void FreeListOpt::free_block(size_t block_index) {
+    set_block_is_allocated(block_index, false);
+    ssize_t prev_block = block_prev_block(block_index);
+    ssize_t next_block = block_next_block(block_index);
 
     // Merge with previous block if it's free
-    if (prev_block != -1 && !block_is_allocated_[prev_block]) {
-        // Look into the size segregated list to remove the block
-        size_t size_segregated_index = get_size_segregated_index(block_size_[prev_block]);
-        std::vector<size_t>& segregated_list = free_blocks_segregated_by_size_[size_segregated_index];
-        auto it = std::find(segregated_list.begin(), segregated_list.end(), prev_block);
-        TT_ASSERT(
-            it != segregated_list.end(),
-            "Prev block {} not found in size segregated list during deallocation of block {}",
-            prev_block,
-            block_index);
-        segregated_list.erase(it);
+    if (prev_block != -1 && !block_is_allocated(prev_block)) {
+        remove_block_from_segregated_list(prev_block);
 
-        block_size_[prev_block] += block_size_[block_index];
-        block_next_block_[prev_block] = next_block;
+        set_block_size(prev_block, block_size(prev_block) + block_size(block_index));
+        set_block_next_block(prev_block, next_block);
         if (next_block != -1) {
-            block_prev_block_[next_block] = prev_block;
+            set_block_prev_block(next_block, prev_block);
         }
         free_meta_block(block_index);
         block_index = prev_block;
     }
 
     // Merge with next block if it's free
-    if (next_block != -1 && !block_is_allocated_[next_block]) {
-        // Look into the size segregated list to remove the block
-        size_t size_segregated_index = get_size_segregated_index(block_size_[next_block]);
-        std::vector<size_t>& segregated_list = free_blocks_segregated_by_size_[size_segregated_index];
-        auto it = std::find(segregated_list.begin(), segregated_list.end(), next_block);
-        TT_ASSERT(
-            it != segregated_list.end(),
-            "Next block {} not found in size segregated list during deallocation of block {}",
-            next_block,
-            block_index);
-        segregated_list.erase(it);
+    if (next_block != -1 && !block_is_allocated(next_block)) {
+        remove_block_from_segregated_list(next_block);
 
-        block_size_[block_index] += block_size_[next_block];
-        block_next_block_[block_index] = block_next_block_[next_block];
-        if (block_next_block_[next_block] != -1) {
-            block_prev_block_[block_next_block_[next_block]] = block_index;
+        set_block_size(block_index, block_size(block_index) + block_size(next_block));
+        set_block_next_block(block_index, block_next_block(next_block));
+        if (block_next_block(next_block) != -1) {
+            set_block_prev_block(block_next_block(next_block), block_index);
         }
         free_meta_block(next_block);
     }
@@ -285,42 +778,319 @@ void FreeListOpt::deallocate(DeviceAddr absolute_address) {
     insert_block_to_segregated_list(block_index);
 }
 
+bool FreeListOpt::push_to_quick_list(size_t block_index) {
+    const DeviceAddr size = block_size(block_index);
+    if (size > quick_list_max_size_) {
+        return false;
+    }
+    auto& quick_list = quick_lists_[quick_list_slot(size)];
+    if (quick_list.size != size) {
+        for (size_t parked_block : quick_list.blocks) {
+            release_quick_list_block(parked_block);
+        }
+        quick_list.blocks.clear();
+        quick_list.size = size;
+    } else if (quick_list.blocks.size() == quick_list_depth_) {
+        release_quick_list_block(quick_list.blocks.front());
+        quick_list.blocks.erase(quick_list.blocks.begin());
+    }
+    quick_list.blocks.push_back(block_index);
+    meta_block_is_allocated_[block_index] = meta_block_in_quick_list;
+    quick_list_bytes_ += size;
+    return true;
+}
+
+std::optional<DeviceAddr> FreeListOpt::allocate_from_quick_list(DeviceAddr alloc_size, DeviceAddr address_limit) {
+    auto& quick_list = quick_lists_[quick_list_slot(alloc_size)];
+    if (quick_list.size != alloc_size || quick_list.blocks.empty()) {
+        return std::nullopt;
+    }
+    // Most recently freed first, it's the most likely to be in cache on the device side too
+    size_t block_index = quick_list.blocks.back();
+    DeviceAddr address = block_address(block_index);
+    if (address + offset_bytes_ < address_limit) {
+        return std::nullopt;
+    }
+    quick_list.blocks.pop_back();
+    meta_block_is_allocated_[block_index] = true;
+    quick_list_bytes_ -= alloc_size;
+    allocated_bytes_ += alloc_size;
+    insert_block_to_alloc_table(address, block_index);
+    maybe_validate();
+    check_watermarks();
+    return address + offset_bytes_;
+}
+
+void FreeListOpt::release_quick_list_block(size_t block_index) {
+    meta_block_is_allocated_[block_index] = true;
+    quick_list_bytes_ -= block_size(block_index);
+    free_block(block_index);
+}
+
+void FreeListOpt::flush_quick_lists() {
+    if (quick_list_bytes_ == 0) {
+        return;
+    }
+    for (auto& quick_list : quick_lists_) {
+        for (size_t block_index : quick_list.blocks) {
+            release_quick_list_block(block_index);
+        }
+        quick_list.blocks.clear();
+    }
+    maybe_compact_metadata();
+    maybe_validate();
+}
+
+void FreeListOpt::set_on_oom(OutOfMemoryCallback callback) { on_oom_ = std::move(callback); }
+
+void FreeListOpt::set_watermarks(DeviceAddr low_free_bytes, DeviceAddr high_free_bytes, WatermarkCallback callback) {
+    TT_FATAL(
+        low_free_bytes <= high_free_bytes,
+        "Low watermark {} must not be above the high watermark {}",
+        low_free_bytes,
+        high_free_bytes);
+    low_watermark_ = low_free_bytes;
+    high_watermark_ = high_free_bytes;
+    on_watermark_ = std::move(callback);
+    below_low_watermark_ = false;
+    check_watermarks();
+}
+
+void FreeListOpt::notify_watermarks() {
+    const DeviceAddr free_bytes = max_size_bytes_ - allocated_bytes_;
+    // State is updated before the call so allocations made by the callback don't fire it again. The callback is copied
+    // as it may replace itself
+    if (!below_low_watermark_ && free_bytes < low_watermark_) {
+        below_low_watermark_ = true;
+        WatermarkCallback on_watermark = on_watermark_;
+        on_watermark(Watermark::LOW, free_bytes);
+    } else if (below_low_watermark_ && free_bytes > high_watermark_) {
+        below_low_watermark_ = false;
+        WatermarkCallback on_watermark = on_watermark_;
+        on_watermark(Watermark::HIGH, free_bytes);
+    }
+}
+
+FreeListOpt::TenantId FreeListOpt::add_tenant(std::string name, DeviceAddr quota_bytes) {
+    TenantId tenant = tenants_.size();
+    tenants_.push_back(TenantStatistics{.id = tenant, .name = std::move(name), .quota_bytes = quota_bytes});
+    return tenant;
+}
+
+void FreeListOpt::set_tenant_quota(TenantId tenant, DeviceAddr quota_bytes) {
+    TT_FATAL(tenant < tenants_.size(), "Unknown tenant {}", tenant);
+    // Lowering the quota below the current usage only stops new allocations, nothing is taken away
+    tenants_[tenant].quota_bytes = quota_bytes;
+}
+
+std::optional<DeviceAddr> FreeListOpt::allocate_for_tenant(
+    TenantId tenant, DeviceAddr size_bytes, bool bottom_up, DeviceAddr address_limit) {
+    DeviceAddr alloc_size = get_alloc_size(size_bytes);
+    if (refuse_over_quota(tenant, alloc_size)) {
+        return std::nullopt;
+    }
+    auto address = allocate(size_bytes, bottom_up, address_limit);
+    charge_tenant(tenant, address, alloc_size);
+    return address;
+}
+
+std::optional<DeviceAddr> FreeListOpt::allocate_at_address_for_tenant(
+    TenantId tenant, DeviceAddr absolute_start_address, DeviceAddr size_bytes) {
+    DeviceAddr alloc_size = get_alloc_size(size_bytes);
+    if (refuse_over_quota(tenant, alloc_size)) {
+        return std::nullopt;
+    }
+    auto address = allocate_at_address(absolute_start_address, size_bytes);
+    charge_tenant(tenant, address, alloc_size);
+    return address;
+}
+
+bool FreeListOpt::refuse_over_quota(TenantId tenant, DeviceAddr alloc_size) {
+    TT_FATAL(tenant < tenants_.size(), "Unknown tenant {}", tenant);
+    TenantStatistics& usage = tenants_[tenant];
+    if (usage.allocated_bytes <= usage.quota_bytes && alloc_size <= usage.quota_bytes - usage.allocated_bytes) {
+        return false;
+    }
+    usage.num_quota_failures++;
+    return true;
+}
+
+void FreeListOpt::charge_tenant(TenantId tenant, std::optional<DeviceAddr> absolute_address, DeviceAddr alloc_size) {
+    if (!absolute_address.has_value()) {
+        return;
+    }
+    TenantStatistics& usage = tenants_[tenant];
+    usage.allocated_bytes += alloc_size;
+    usage.peak_allocated_bytes = std::max(usage.peak_allocated_bytes, usage.allocated_bytes);
+    usage.num_allocations++;
+    tenant_allocations_[*absolute_address] = tenant;
+}
+
+void FreeListOpt::release_tenant_allocation(DeviceAddr absolute_address, DeviceAddr alloc_size) {
+    auto it = tenant_allocations_.find(absolute_address);
+    if (it == tenant_allocations_.end()) {
+        return;
+    }
+    TenantStatistics& usage = tenants_[it->second];
+    usage.allocated_bytes -= alloc_size;
+    usage.num_allocations--;
+    tenant_allocations_.erase(it);
+}
+
+void FreeListOpt::clear_tenant_allocations() {
+    tenant_allocations_.clear();
+    for (auto& usage : tenants_) {
+        usage.allocated_bytes = 0;
+        usage.num_allocations = 0;
+    }
+}
+
+std::vector<std::pair<DeviceAddr, DeviceAddr>> FreeListOpt::free_ranges_with_quick_lists() const {
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> ranges;
+    for (ssize_t i = find_head_block(); i != -1; i = block_next_block(i)) {
+        if (block_is_allocated(i) && meta_block_is_allocated_[i] != meta_block_in_quick_list) {
+            continue;
+        }
+        DeviceAddr start = block_address(i);
+        DeviceAddr end = start + block_size(i);
+        if (!ranges.empty() && ranges.back().second == start) {
+            ranges.back().second = end;
+        } else {
+            ranges.emplace_back(start, end);
+        }
+    }
+    return ranges;
+}
+
+bool FreeListOpt::next_free_range(
+    ssize_t& block_index, bool forward, std::pair<DeviceAddr, DeviceAddr>& range) const {
+    auto is_free = [this](ssize_t i) {
+        return !block_is_allocated(i) || meta_block_is_allocated_[i] == meta_block_in_quick_list;
+    };
+    while (block_index != -1 && !is_free(block_index)) {
+        block_index = forward ? block_next_block(block_index) : block_prev_block(block_index);
+    }
+    if (block_index == -1) {
+        return false;
+    }
+    range = {block_address(block_index), block_address(block_index) + block_size(block_index)};
+    while (true) {
+        block_index = forward ? block_next_block(block_index) : block_prev_block(block_index);
+        if (block_index == -1 || !is_free(block_index)) {
+            return true;
+        }
+        if (forward) {
+            range.second = block_address(block_index) + block_size(block_index);
+        } else {
+            range.first = block_address(block_index);
+        }
+    }
+}
+
+std::optional<DeviceAddr> FreeListOpt::find_common_free_address(
+    const std::vector<const FreeListOpt*>& banks, DeviceAddr size_bytes, bool bottom_up) {
+    if (banks.empty()) {
+        return std::nullopt;
+    }
+    DeviceAddr alloc_size = 0;
+    for (const FreeListOpt* bank : banks) {
+        TT_FATAL(
+            bank->alignment_ == banks.front()->alignment_,
+            "All banks must have the same alignment, got {} and {} B",
+            bank->alignment_,
+            banks.front()->alignment_);
+        alloc_size = std::max(alloc_size, bank->get_alloc_size(size_bytes));
+    }
+
+    struct Cursor {
+        ssize_t block_index;
+        std::pair<DeviceAddr, DeviceAddr> range;  // Current free range, empty before the first one
+    };
+    std::vector<Cursor> cursors(banks.size());
+    for (size_t i = 0; i < banks.size(); i++) {
+        cursors[i].block_index = bottom_up ? banks[i]->find_head_block() : banks[i]->find_tail_block();
+        cursors[i].range = {0, 0};
+    }
+
+    // [start, start + alloc_size) is free in the last n_agreed banks visited. Visit the banks round robin, moving each
+    // to its first range that could still hold the candidate. A range that doesn't cover the candidate moves it up (or
+    // down) to the range edge, which the banks visited since have to confirm again
+    DeviceAddr start = bottom_up ? 0 : std::numeric_limits<DeviceAddr>::max();
+    size_t n_agreed = 0;
+    for (size_t i = 0; n_agreed < banks.size(); i = i + 1 == banks.size() ? 0 : i + 1) {
+        Cursor& cursor = cursors[i];
+        auto [range_start, range_end] = cursor.range;
+        while (range_end - range_start < alloc_size ||
+               (bottom_up ? range_end - alloc_size < start : range_start > start)) {
+            if (!banks[i]->next_free_range(cursor.block_index, bottom_up, cursor.range)) {
+                return std::nullopt;
+            }
+            std::tie(range_start, range_end) = cursor.range;
+        }
+        if (bottom_up ? range_start > start : range_end - alloc_size < start) {
+            start = bottom_up ? range_start : range_end - alloc_size;
+            n_agreed = 1;
+        } else {
+            n_agreed++;
+        }
+    }
+    return start;
+}
+
 std::vector<std::pair<DeviceAddr, DeviceAddr>> FreeListOpt::available_addresses(DeviceAddr size_bytes) const {
-    size_t alloc_size = align(std::max(size_bytes, min_allocation_size_));
+    size_t alloc_size = get_alloc_size(size_bytes);
     size_t size_segregated_index = get_size_segregated_index(alloc_size);
     std::vector<std::pair<DeviceAddr, DeviceAddr>> addresses;
 
+    if (quick_list_bytes_ != 0) {
+        // Parked blocks would be coalesced before an allocation fails, so report them merged with their neighbours
+        for (const auto& [start, end] : free_ranges_with_quick_lists()) {
+            if (end - start >= alloc_size) {
+                addresses.emplace_back(start, end);
+            }
+        }
+        return addresses;
+    }
+
     for (size_t i = size_segregated_index; i < size_segregated_count; i++) {
         for (size_t j = 0; j < free_blocks_segregated_by_size_[i].size(); j++) {
             size_t block_index = free_blocks_segregated_by_size_[i][j];
-            if (block_size_[block_index] >= alloc_size) {
+            if (free_block_sizes_segregated_by_size_[i][j] >= alloc_size) {
                 addresses.push_back(
-                    {block_address_[block_index], block_address_[block_index] + block_size_[block_index]});
+                    {block_address(block_index), block_address(block_index) + block_size(block_index)});
             }
         }
     }
     return addresses;
 }
 
+size_t FreeListOpt::available_addresses(
+    DeviceAddr size_bytes, std::pair<DeviceAddr, DeviceAddr>* out, size_t capacity) const {
+    size_t n_ranges = 0;
+    if (capacity == 0) {
+        return 0;
+    }
+    for_each_available_address(size_bytes, [&](DeviceAddr start, DeviceAddr end) {
+        out[n_ranges++] = {start, end};
+        return n_ranges < capacity;
+    });
+    return n_ranges;
+}
+
 size_t FreeListOpt::alloc_meta_block(
     DeviceAddr address, DeviceAddr size, ssize_t prev_block, ssize_t next_block, bool is_allocated) {
     size_t idx;
     if (free_meta_block_indices_.empty()) {
-        idx = block_address_.size();
-        block_address_.push_back(address);
-        block_size_.push_back(size);
-        block_prev_block_.push_back(prev_block);
-        block_next_block_.push_back(next_block);
-        block_is_allocated_.push_back(is_allocated);
-        meta_block_is_allocated_.push_back(true);
+        idx = block_table_size();
+        push_block(address, size, prev_block, next_block, is_allocated);
     } else {
         idx = free_meta_block_indices_.back();
         free_meta_block_indices_.pop_back();
-        block_address_[idx] = address;
-        block_size_[idx] = size;
-        block_prev_block_[idx] = prev_block;
-        block_next_block_[idx] = next_block;
-        block_is_allocated_[idx] = is_allocated;
+        set_block_address(idx, address);
+        set_block_size(idx, size);
+        set_block_prev_block(idx, prev_block);
+        set_block_next_block(idx, next_block);
+        set_block_is_allocated(idx, is_allocated);
         meta_block_is_allocated_[idx] = true;
     }
     return idx;
@@ -331,8 +1101,389 @@ void FreeListOpt::free_meta_block(size_t block_index) {
     meta_block_is_allocated_[block_index] = false;
 }
 
+void FreeListOpt::maybe_compact_metadata() {
+    if (free_meta_block_indices_.size() >= metadata_compaction_min_dead_blocks &&
+        free_meta_block_indices_.size() > block_table_size() * metadata_compaction_dead_ratio) {
+        compact_metadata();
+    }
+}
+
+void FreeListOpt::compact_metadata() {
+    const size_t n_slots = block_table_size();
+    const size_t n_blocks = n_slots - free_meta_block_indices_.size();
+    struct LiveBlock {
+        DeviceAddr address;
+        DeviceAddr size;
+        bool is_allocated;
+    };
+    std::vector<LiveBlock> live_blocks;
+    live_blocks.reserve(n_blocks);
+
+    // Renumber in address order. Neighbours end up next to each other in memory, which helps coalescing too
+    std::vector<size_t> new_index(n_slots, -1);
+    for (ssize_t i = find_head_block(); i != -1; i = block_next_block(i)) {
+        new_index[i] = live_blocks.size();
+        live_blocks.push_back({block_address(i), block_size(i), block_is_allocated(i)});
+    }
+    TT_ASSERT(live_blocks.size() == n_blocks, "Block list and metadata table disagree on the number of blocks");
+
+    clear_block_table();
+    for (size_t i = 0; i < live_blocks.size(); i++) {
+        ssize_t prev_block = i == 0 ? -1 : ssize_t(i - 1);
+        ssize_t next_block = i + 1 == live_blocks.size() ? -1 : ssize_t(i + 1);
+        push_block(live_blocks[i].address, live_blocks[i].size, prev_block, next_block, live_blocks[i].is_allocated);
+    }
+    block_address_.shrink_to_fit();
+    block_size_.shrink_to_fit();
+    block_prev_block_.shrink_to_fit();
+    block_next_block_.shrink_to_fit();
+    block_is_allocated_.shrink_to_fit();
+    compact_blocks_.shrink_to_fit();
+    meta_block_is_allocated_.shrink_to_fit();
+    free_meta_block_indices_.clear();
+    free_meta_block_indices_.shrink_to_fit();
+
+    // Renumbering is monotonic in address, so the segregated lists stay sorted
+    for (auto& free_blocks : free_blocks_segregated_by_size_) {
+        for (auto& block_index : free_blocks) {
+            block_index = new_index[block_index];
+        }
+    }
+    for (auto& bucket : allocated_block_table_) {
+        for (auto& [addr, block_index] : bucket) {
+            block_index = new_index[block_index];
+        }
+    }
+    for (auto& quick_list : quick_lists_) {
+        for (auto& block_index : quick_list.blocks) {
+            block_index = new_index[block_index];
+            meta_block_is_allocated_[block_index] = meta_block_in_quick_list;
+        }
+    }
+    maybe_validate();
+}
+
+size_t FreeListOpt::metadata_memory_bytes() const {
+    size_t bytes = sizeof(*this);
+    bytes += block_address_.capacity() * sizeof(DeviceAddr);
+    bytes += block_size_.capacity() * sizeof(DeviceAddr);
+    bytes += block_prev_block_.capacity() * sizeof(ssize_t);
+    bytes += block_next_block_.capacity() * sizeof(ssize_t);
+    bytes += block_is_allocated_.capacity() * sizeof(uint8_t);
+    bytes += compact_blocks_.capacity() * sizeof(CompactBlock);
+    bytes += meta_block_is_allocated_.capacity() * sizeof(uint8_t);
+    bytes += free_meta_block_indices_.capacity() * sizeof(size_t);
+    for (const auto& bucket : allocated_block_table_) {
+        bytes += sizeof(bucket) + bucket.capacity() * sizeof(bucket[0]);
+    }
+    for (const auto& free_blocks : free_blocks_segregated_by_size_) {
+        bytes += sizeof(free_blocks) + free_blocks.capacity() * sizeof(size_t);
+    }
+    for (const auto& free_block_sizes : free_block_sizes_segregated_by_size_) {
+        bytes += sizeof(free_block_sizes) + free_block_sizes.capacity() * sizeof(DeviceAddr);
+    }
+    for (const auto& quick_list : quick_lists_) {
+        bytes += sizeof(quick_list) + quick_list.blocks.capacity() * sizeof(size_t);
+    }
+    return bytes;
+}
+
+void FreeListOpt::push_block(
+    DeviceAddr address, DeviceAddr size, ssize_t prev_block, ssize_t next_block, bool is_allocated) {
+    if (compact_layout_) {
+        compact_blocks_.push_back({});
+    } else {
+        block_address_.push_back(0);
+        block_size_.push_back(0);
+        block_prev_block_.push_back(0);
+        block_next_block_.push_back(0);
+        block_is_allocated_.push_back(false);
+    }
+    meta_block_is_allocated_.push_back(true);
+    size_t idx = block_table_size() - 1;
+    set_block_address(idx, address);
+    set_block_size(idx, size);
+    set_block_prev_block(idx, prev_block);
+    set_block_next_block(idx, next_block);
+    set_block_is_allocated(idx, is_allocated);
+}
+
+void FreeListOpt::clear_block_table() {
+    block_address_.clear();
+    block_size_.clear();
+    block_prev_block_.clear();
+    block_next_block_.clear();
+    block_is_allocated_.clear();
+    compact_blocks_.clear();
+    meta_block_is_allocated_.clear();
+}
+
 void FreeListOpt::clear() { init(); }
 
+void FreeListOpt::maybe_validate() const {
+#ifdef TT_ALLOC_VALIDATE
+    validate();
+#else
+    if (validate_after_each_operation_) {
+        validate();
+    }
+#endif
+}
+
+void FreeListOpt::validate() const {
+    const size_t n_slots = block_table_size();
+    size_t n_live_slots = 0;
+    ssize_t head_block = -1;
+    for (size_t i = 0; i < n_slots; i++) {
+        if (!meta_block_is_allocated_[i]) {
+            continue;
+        }
+        n_live_slots++;
+        if (block_prev_block(i) == -1) {
+            if (head_block != -1) {
+                validation_failure("blocks {} and {} both have no previous block", head_block, i);
+            }
+            head_block = i;
+        }
+    }
+    if (head_block == -1) {
+        validation_failure("no head block");
+    }
+
+    // Walk the block list. It must reach every live slot once, link back correctly and tile the bank
+    std::vector<uint8_t> seen(n_slots, false);
+    size_t n_free_blocks = 0;
+    size_t n_allocated_blocks = 0;
+    size_t n_parked_blocks = 0;
+    DeviceAddr parked_bytes = 0;
+    DeviceAddr allocated_bytes = 0;
+    DeviceAddr expected_address = shrink_size_;
+    ssize_t prev_block = -1;
+    for (ssize_t i = head_block; i != -1; i = block_next_block(i)) {
+        if (size_t(i) >= n_slots || !meta_block_is_allocated_[i]) {
+            validation_failure("block {} links to block {} which is not in use", prev_block, i);
+        }
+        if (seen[i]) {
+            validation_failure("the block list loops back to block {}", i);
+        }
+        seen[i] = true;
+        if (block_prev_block(i) != prev_block) {
+            validation_failure("block {} links back to block {} instead of {}", i, block_prev_block(i), prev_block);
+        }
+        if (block_address(i) != expected_address) {
+            validation_failure("block {} starts at {}, expected {}", i, block_address(i), expected_address);
+        }
+        if (block_size(i) == 0) {
+            validation_failure("block {} is empty", i);
+        }
+        if (meta_block_is_allocated_[i] == meta_block_in_quick_list) {
+            if (!block_is_allocated(i)) {
+                validation_failure("block {} is on a quick list but marked free", i);
+            }
+            n_parked_blocks++;
+            parked_bytes += block_size(i);
+        } else if (block_is_allocated(i)) {
+            n_allocated_blocks++;
+            allocated_bytes += block_size(i);
+        } else {
+            if (prev_block != -1 && !block_is_allocated(prev_block)) {
+                validation_failure("free blocks {} and {} are adjacent", prev_block, i);
+            }
+            n_free_blocks++;
+        }
+        expected_address += block_size(i);
+        prev_block = i;
+    }
+    if (expected_address != shrink_size_ + max_size_bytes_) {
+        validation_failure("blocks end at {}, expected {}", expected_address, shrink_size_ + max_size_bytes_);
+    }
+    if (allocated_bytes != allocated_bytes_) {
+        validation_failure("{} B are allocated but {} B are accounted for", allocated_bytes, allocated_bytes_);
+    }
+    if (n_free_blocks + n_allocated_blocks + n_parked_blocks != n_live_slots) {
+        validation_failure(
+            "{} slots are in use but {} blocks are reachable from the head",
+            n_live_slots,
+            n_free_blocks + n_allocated_blocks + n_parked_blocks);
+    }
+
+    // The recycled slots are exactly the unused ones
+    if (free_meta_block_indices_.size() != n_slots - n_live_slots) {
+        validation_failure(
+            "{} slots are unused but {} are up for reuse", n_slots - n_live_slots, free_meta_block_indices_.size());
+    }
+    std::fill(seen.begin(), seen.end(), false);
+    for (size_t block_index : free_meta_block_indices_) {
+        if (block_index >= n_slots || meta_block_is_allocated_[block_index] || seen[block_index]) {
+            validation_failure("slot {} is up for reuse but is in use or listed twice", block_index);
+        }
+        seen[block_index] = true;
+    }
+
+    // Every free block is in its size class exactly once, with the right size, in order
+    size_t n_segregated_blocks = 0;
+    std::fill(seen.begin(), seen.end(), false);
+    for (size_t size_class = 0; size_class < size_segregated_count; size_class++) {
+        const auto& free_blocks = free_blocks_segregated_by_size_[size_class];
+        const auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_class];
+        if (free_blocks.size() != free_block_sizes.size()) {
+            validation_failure(
+                "size class {} has {} blocks but {} sizes", size_class, free_blocks.size(), free_block_sizes.size());
+        }
+        for (size_t j = 0; j < free_blocks.size(); j++) {
+            size_t block_index = free_blocks[j];
+            if (block_index >= n_slots || !meta_block_is_allocated_[block_index] || block_is_allocated(block_index)) {
+                validation_failure("size class {} holds block {} which is not a free block", size_class, block_index);
+            }
+            if (seen[block_index]) {
+                validation_failure("block {} is in the size segregated lists twice", block_index);
+            }
+            seen[block_index] = true;
+            if (get_size_segregated_index(block_size(block_index)) != size_class) {
+                validation_failure(
+                    "block {} of {} B is in size class {}, expected {}",
+                    block_index,
+                    block_size(block_index),
+                    size_class,
+                    get_size_segregated_index(block_size(block_index)));
+            }
+            if (free_block_sizes[j] != block_size(block_index)) {
+                validation_failure(
+                    "size class {} records {} B for block {} of {} B",
+                    size_class,
+                    free_block_sizes[j],
+                    block_index,
+                    block_size(block_index));
+            }
+            if (j > 0) {
+                size_t prev_index = free_blocks[j - 1];
+                bool in_order =
+                    size_ordered_classes_
+                        ? std::make_pair(block_size(prev_index), block_address(prev_index)) <
+                              std::make_pair(block_size(block_index), block_address(block_index))
+                        : block_address(prev_index) < block_address(block_index);
+                if (!in_order) {
+                    validation_failure(
+                        "size class {} is out of order at blocks {} and {}", size_class, prev_index, block_index);
+                }
+            }
+        }
+        n_segregated_blocks += free_blocks.size();
+    }
+    if (n_segregated_blocks != n_free_blocks) {
+        validation_failure("{} free blocks but {} in the size segregated lists", n_free_blocks, n_segregated_blocks);
+    }
+
+    // The allocated block table covers exactly the allocated blocks that aren't parked
+    size_t n_alloc_table_blocks = 0;
+    std::fill(seen.begin(), seen.end(), false);
+    for (size_t bucket = 0; bucket < allocated_block_table_.size(); bucket++) {
+        for (const auto& [address, block_index] : allocated_block_table_[bucket]) {
+            if (block_index >= n_slots || meta_block_is_allocated_[block_index] != true ||
+                !block_is_allocated(block_index)) {
+                validation_failure("allocated block table holds block {} which is not allocated", block_index);
+            }
+            if (seen[block_index]) {
+                validation_failure("block {} is in the allocated block table twice", block_index);
+            }
+            seen[block_index] = true;
+            if (address != block_address(block_index)) {
+                validation_failure(
+                    "allocated block table maps {} to block {} at {}",
+                    address,
+                    block_index,
+                    block_address(block_index));
+            }
+            if (hash_device_address(address) != bucket) {
+                validation_failure(
+                    "address {} is in bucket {}, expected {}", address, bucket, hash_device_address(address));
+            }
+        }
+        n_alloc_table_blocks += allocated_block_table_[bucket].size();
+    }
+    if (n_alloc_table_blocks != n_allocated_blocks) {
+        validation_failure(
+            "{} allocated blocks but {} in the allocated block table", n_allocated_blocks, n_alloc_table_blocks);
+    }
+
+    // The quick lists hold exactly the parked blocks
+    size_t n_quick_list_blocks = 0;
+    std::fill(seen.begin(), seen.end(), false);
+    for (size_t slot = 0; slot < quick_lists_.size(); slot++) {
+        const auto& quick_list = quick_lists_[slot];
+        if (quick_list.blocks.size() > quick_list_depth_) {
+            validation_failure("quick list {} holds {} blocks, more than its depth", slot, quick_list.blocks.size());
+        }
+        if (!quick_list.blocks.empty() && quick_list_slot(quick_list.size) != slot) {
+            validation_failure(
+                "quick list {} holds blocks of {} B which belong in {}",
+                slot,
+                quick_list.size,
+                quick_list_slot(quick_list.size));
+        }
+        for (size_t block_index : quick_list.blocks) {
+            if (block_index >= n_slots || meta_block_is_allocated_[block_index] != meta_block_in_quick_list) {
+                validation_failure("quick list {} holds block {} which is not parked", slot, block_index);
+            }
+            if (seen[block_index]) {
+                validation_failure("block {} is on the quick lists twice", block_index);
+            }
+            seen[block_index] = true;
+            if (block_size(block_index) != quick_list.size) {
+                validation_failure(
+                    "quick list {} of {} B holds block {} of {} B",
+                    slot,
+                    quick_list.size,
+                    block_index,
+                    block_size(block_index));
+            }
+        }
+        n_quick_list_blocks += quick_list.blocks.size();
+    }
+    if (n_quick_list_blocks != n_parked_blocks) {
+        validation_failure("{} parked blocks but {} on the quick lists", n_parked_blocks, n_quick_list_blocks);
+    }
+    if (parked_bytes != quick_list_bytes_) {
+        validation_failure("{} B parked but the quick lists count {} B", parked_bytes, quick_list_bytes_);
+    }
+}
+
+std::vector<DeviceAddr> FreeListOpt::size_classes_from_histogram(
+    const std::vector<std::pair<DeviceAddr, size_t>>& histogram, size_t n_classes) {
+    TT_FATAL(n_classes >= 2, "Need at least 2 size classes, got {}", n_classes);
+    auto sorted_histogram = histogram;
+    std::sort(sorted_histogram.begin(), sorted_histogram.end());
+    size_t total_count = 0;
+    for (const auto& [size, count] : sorted_histogram) {
+        total_count += count;
+    }
+
+    std::vector<DeviceAddr> bounds = {0};
+    if (total_count == 0) {
+        return bounds;
+    }
+    // n_classes - 1 classes split the recorded sizes at their quantiles, the last one is for larger blocks
+    const size_t n_quantile_classes = n_classes - 1;
+    size_t cumulative_count = 0;
+    size_t next_class = 1;
+    for (const auto& [size, count] : sorted_histogram) {
+        if (next_class < n_quantile_classes && cumulative_count * n_quantile_classes >= next_class * total_count &&
+            size > bounds.back()) {
+            bounds.push_back(size);
+            while (next_class < n_quantile_classes &&
+                   cumulative_count * n_quantile_classes >= next_class * total_count) {
+                next_class++;
+            }
+        }
+        cumulative_count += count;
+    }
+    DeviceAddr largest_size = sorted_histogram.back().first;
+    if (largest_size + 1 > bounds.back()) {
+        bounds.push_back(largest_size + 1);
+    }
+    return bounds;
+}
+
 Statistics FreeListOpt::get_statistics() const {
     // TODO: Cache the statistics
     size_t total_allocated_bytes = 0;
@@ -340,15 +1491,31 @@ Statistics FreeListOpt::get_statistics() const {
     size_t largest_free_block_bytes = 0;
     std::vector<uint32_t> largest_free_block_addrs;
 
-    for (size_t i = 0; i < block_address_.size(); i++) {
-        if (block_is_allocated_[i]) {
-            total_allocated_bytes += block_size_[i];
+    for (size_t i = 0; i < block_table_size(); i++) {
+        if (!meta_block_is_allocated_[i]) {
+            continue;
+        } else if (block_is_allocated(i)) {
+            total_allocated_bytes += block_size(i);
         } else {
-            total_free_bytes += block_size_[i];
-            if (block_size_[i] >= largest_free_block_bytes) {
-                largest_free_block_bytes = block_size_[i];
+            total_free_bytes += block_size(i);
+            if (block_size(i) >= largest_free_block_bytes) {
+                largest_free_block_bytes = block_size(i);
                 // XXX: This is going to overflow
-                largest_free_block_addrs.push_back(block_address_[i] + offset_bytes_);
+                largest_free_block_addrs.push_back(block_address(i) + offset_bytes_);
+            }
+        }
+    }
+
+    if (quick_list_bytes_ != 0) {
+        // Parked blocks are free memory. Measure the free blocks as they will be once the parked ones are coalesced
+        total_allocated_bytes -= quick_list_bytes_;
+        total_free_bytes += quick_list_bytes_;
+        largest_free_block_bytes = 0;
+        largest_free_block_addrs.clear();
+        for (const auto& [start, end] : free_ranges_with_quick_lists()) {
+            if (end - start >= largest_free_block_bytes) {
+                largest_free_block_bytes = end - start;
+                largest_free_block_addrs.push_back(start + offset_bytes_);
             }
         }
     }
@@ -366,6 +1533,7 @@ Statistics FreeListOpt::get_statistics() const {
         // Why do we need largest_free_block_addrs? Without it the entire loop can be removed
         // and statistics can be tracked during allocation and deallocation
         .largest_free_block_addrs = std::move(largest_free_block_addrs),
+        .tenants = tenants_,
     };
 }
 
@@ -374,11 +1542,10 @@ void FreeListOpt::dump_blocks(std::ostream& out) const {
     out << "segregated free blocks by size:" << std::endl;
     for (size_t i = 0; i < free_blocks_segregated_by_size_.size(); i++) {
         if (i != free_blocks_segregated_by_size_.size() - 1) {
-            out << "  Size class " << i << ": (" << size_t(size_segregated_base * (size_t{1} << i)) << " - "
-                << size_t(size_segregated_base * (size_t{1} << (i + 1))) << ") blocks: ";
+            out << "  Size class " << i << ": (" << size_class_lower_bounds_[i] << " - "
+                << size_class_lower_bounds_[i + 1] << ") blocks: ";
         } else {
-            out << "  Size class " << i << ": (" << size_t(size_segregated_base * (size_t{1} << i))
-                << " - inf) blocks: ";
+            out << "  Size class " << i << ": (" << size_class_lower_bounds_[i] << " - inf) blocks: ";
         }
         for (size_t j = 0; j < free_blocks_segregated_by_size_[i].size(); j++) {
             out << free_blocks_segregated_by_size_[i][j] << " ";
@@ -387,6 +1554,20 @@ void FreeListOpt::dump_blocks(std::ostream& out) const {
         out << std::endl;
     }
 
+    if (quick_list_bytes_ != 0) {
+        out << "Quick lists:" << std::endl;
+        for (const auto& quick_list : quick_lists_) {
+            if (quick_list.blocks.empty()) {
+                continue;
+            }
+            out << "  Size " << quick_list.size << " blocks: ";
+            for (size_t block_index : quick_list.blocks) {
+                out << block_index << " ";
+            }
+            out << std::endl;
+        }
+    }
+
     out << "Free slots in block table: ";
     for (size_t i = 0; i < free_meta_block_indices_.size(); i++) {
         out << free_meta_block_indices_[i] << " ";
@@ -413,22 +1594,415 @@ void FreeListOpt::dump_blocks(std::ostream& out) const {
         out << leftpad(header, pad) << " ";
     }
     out << std::endl;
-    for (size_t i = 0; i < block_address_.size(); i++) {
+    for (size_t i = 0; i < block_table_size(); i++) {
         if (!meta_block_is_allocated_[i]) {
             continue;
         }
-        out << leftpad_num(i, pad) << " " << leftpad_num(block_address_[i], pad) << " "
-            << leftpad_num(block_size_[i], pad) << " " << leftpad_num(block_prev_block_[i], pad) << " "
-            << leftpad_num(block_next_block_[i], pad) << " " << leftpad(block_is_allocated_[i] ? "yes" : "no", pad)
+        out << leftpad_num(i, pad) << " " << leftpad_num(block_address(i), pad) << " "
+            << leftpad_num(block_size(i), pad) << " " << leftpad_num(block_prev_block(i), pad) << " "
+            << leftpad_num(block_next_block(i), pad) << " "
+            << leftpad(
+                   meta_block_is_allocated_[i] == meta_block_in_quick_list ? "quick"
+                   : block_is_allocated(i)                                 ? "yes"
+                                                                           : "no",
+                   pad)
             << std::endl;
     }
 }
 
+void FreeListOpt::dump_blocks(std::ostream& out, DumpFormat format) const {
+    if (format == DumpFormat::TEXT) {
+        dump_blocks(out);
+        return;
+    }
+    // Built in memory and written at once, streaming piece by piece through the ostream is most of the cost otherwise.
+    // The per block formats are compiled, runtime format string parsing costs more than the formatting itself
+    const Statistics stats = get_statistics();
+    const size_t n_blocks = block_table_size() - free_meta_block_indices_.size();
+    auto block_state = [](const BlockView& block) -> uint8_t {
+        return block.in_quick_list ? 2 : block.is_allocated ? 1 : 0;
+    };
+
+    if (format == DumpFormat::JSON) {
+        fmt::memory_buffer json;
+        json.reserve(256 + n_blocks * 96);
+        auto it = std::back_inserter(json);
+        auto append = [&json](std::string_view str) { json.append(str); };
+        fmt::format_to(
+            it,
+            "{{\"max_size_bytes\":{},\"offset_bytes\":{},\"alignment\":{},\"shrink_size\":{},",
+            max_size_bytes_,
+            offset_bytes_,
+            alignment_,
+            shrink_size_);
+        fmt::format_to(
+            it,
+            "\"statistics\":{{\"total_allocatable_size_bytes\":{},\"total_allocated_bytes\":{},\"total_free_bytes\":{},"
+            "\"largest_free_block_bytes\":{}}},",
+            stats.total_allocatable_size_bytes,
+            stats.total_allocated_bytes,
+            stats.total_free_bytes,
+            stats.largest_free_block_bytes);
+        append("\"size_classes\":[");
+        for (size_t i = 0; i < size_segregated_count; i++) {
+            fmt::format_to(
+                it, FMT_COMPILE("{}{{\"lower_bound\":{},\"blocks\":["), i == 0 ? "" : ",", size_class_lower_bounds_[i]);
+            const auto& free_blocks = free_blocks_segregated_by_size_[i];
+            for (size_t j = 0; j < free_blocks.size(); j++) {
+                fmt::format_to(it, FMT_COMPILE("{}{}"), j == 0 ? "" : ",", free_blocks[j]);
+            }
+            append("]}");
+        }
+        append("],\"quick_lists\":[");
+        bool first_quick_list = true;
+        for (const auto& quick_list : quick_lists_) {
+            if (quick_list.blocks.empty()) {
+                continue;
+            }
+            fmt::format_to(
+                it, FMT_COMPILE("{}{{\"size\":{},\"blocks\":["), first_quick_list ? "" : ",", quick_list.size);
+            for (size_t j = 0; j < quick_list.blocks.size(); j++) {
+                fmt::format_to(it, FMT_COMPILE("{}{}"), j == 0 ? "" : ",", quick_list.blocks[j]);
+            }
+            append("]}");
+            first_quick_list = false;
+        }
+        append("],\"unused_slots\":[");
+        for (size_t j = 0; j < free_meta_block_indices_.size(); j++) {
+            fmt::format_to(it, FMT_COMPILE("{}{}"), j == 0 ? "" : ",", free_meta_block_indices_[j]);
+        }
+        append("],\"blocks\":[");
+        const char* state_names[] = {"free", "allocated", "quick"};
+        bool first_block = true;
+        for_each_block([&](const BlockView& block) {
+            fmt::format_to(
+                it,
+                FMT_COMPILE("{}{{\"id\":{},\"address\":{},\"size\":{},\"prev\":{},\"next\":{},\"state\":\"{}\"}}"),
+                first_block ? "" : ",",
+                block.id,
+                block.address,
+                block.size,
+                block.prev_block,
+                block.next_block,
+                state_names[block_state(block)]);
+            first_block = false;
+        });
+        append("]}\n");
+        out.write(json.data(), json.size());
+        return;
+    }
+
+    std::string buffer;
+    auto put = [&buffer](auto value) { buffer.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    buffer.reserve(128 + n_blocks * 64);
+    buffer.append("TTFL", 4);
+    put(uint32_t{1});
+    for (uint64_t value :
+         {max_size_bytes_,
+          offset_bytes_,
+          alignment_,
+          shrink_size_,
+          stats.total_allocated_bytes,
+          stats.total_free_bytes,
+          stats.largest_free_block_bytes}) {
+        put(value);
+    }
+    put(uint64_t(size_segregated_count));
+    for (size_t i = 0; i < size_segregated_count; i++) {
+        put(uint64_t(size_class_lower_bounds_[i]));
+        put(uint64_t(free_blocks_segregated_by_size_[i].size()));
+        for (size_t block_index : free_blocks_segregated_by_size_[i]) {
+            put(uint64_t(block_index));
+        }
+    }
+    put(uint64_t(std::count_if(quick_lists_.begin(), quick_lists_.end(), [](const QuickList& quick_list) {
+        return !quick_list.blocks.empty();
+    })));
+    for (const auto& quick_list : quick_lists_) {
+        if (quick_list.blocks.empty()) {
+            continue;
+        }
+        put(uint64_t(quick_list.size));
+        put(uint64_t(quick_list.blocks.size()));
+        for (size_t block_index : quick_list.blocks) {
+            put(uint64_t(block_index));
+        }
+    }
+    put(uint64_t(free_meta_block_indices_.size()));
+    for (size_t slot : free_meta_block_indices_) {
+        put(uint64_t(slot));
+    }
+    put(uint64_t(n_blocks));
+    for_each_block([&](const BlockView& block) {
+        put(uint64_t(block.id));
+        put(uint64_t(block.address));
+        put(uint64_t(block.size));
+        put(int64_t(block.prev_block));
+        put(int64_t(block.next_block));
+        put(block_state(block));
+        buffer.append(7, '\0');
+    });
+    out.write(buffer.data(), buffer.size());
+}
+
+std::vector<uint8_t> FreeListOpt::serialize() const {
+    const size_t n_slots = block_table_size();
+    SerializedHeader header{};
+    std::memcpy(header.magic, "TTFS", 4);
+    header.version = serialized_version;
+    header.flags = (compact_layout_ ? serialized_compact_layout : 0) |
+                   (size_ordered_classes_ ? serialized_size_ordered_classes : 0);
+    header.max_size_bytes = max_size_bytes_;
+    header.shrink_size = shrink_size_;
+    header.offset_bytes = offset_bytes_;
+    header.min_allocation_size = min_allocation_size_;
+    header.alignment = alignment_;
+    header.allocated_bytes = allocated_bytes_;
+    header.quick_list_bytes = quick_list_bytes_;
+    header.next_fit_rover = next_fit_rover_;
+    header.n_slots = n_slots;
+    header.n_unused_slots = free_meta_block_indices_.size();
+    header.n_size_classes = size_segregated_count;
+    header.n_quick_lists = quick_lists_.size();
+    header.n_alloc_table_buckets = allocated_block_table_.size();
+
+    BlobWriter writer;
+    writer.put(header);
+    writer.put_array(size_class_lower_bounds_.data(), size_segregated_count);
+    if (compact_layout_) {
+        writer.put_array(compact_blocks_.data(), n_slots);
+    } else {
+        writer.put_array(block_address_.data(), n_slots);
+        writer.put_array(block_size_.data(), n_slots);
+        writer.put_array(block_prev_block_.data(), n_slots);
+        writer.put_array(block_next_block_.data(), n_slots);
+        writer.put_array(block_is_allocated_.data(), n_slots);
+    }
+    writer.put_array(meta_block_is_allocated_.data(), n_slots);
+    writer.put_array(free_meta_block_indices_.data(), free_meta_block_indices_.size());
+
+    // Lists of lists are written as the list sizes followed by all the elements
+    auto put_lists = [&writer](const auto& lists, auto&& list_of) {
+        for (const auto& list : lists) {
+            writer.put(uint64_t(list_of(list).size()));
+        }
+        for (const auto& list : lists) {
+            writer.put_array(list_of(list).data(), list_of(list).size());
+        }
+    };
+    auto identity = [](const auto& list) -> const auto& { return list; };
+    put_lists(free_blocks_segregated_by_size_, identity);
+    for (const auto& sizes : free_block_sizes_segregated_by_size_) {
+        writer.put_array(sizes.data(), sizes.size());
+    }
+    for (const auto& quick_list : quick_lists_) {
+        writer.put(uint64_t(quick_list.size));
+    }
+    put_lists(quick_lists_, [](const QuickList& quick_list) -> const auto& { return quick_list.blocks; });
+    put_lists(allocated_block_table_, identity);
+
+    std::vector<uint8_t>& blob = writer.blob();
+    SerializedHeader* written_header = reinterpret_cast<SerializedHeader*>(blob.data());
+    written_header->size_bytes = blob.size();
+    written_header->checksum =
+        checksum_blob(blob.data() + serialized_checksum_start, blob.size() - serialized_checksum_start);
+    return std::move(blob);
+}
+
+void FreeListOpt::deserialize(const void* data, size_t size_bytes) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    SerializedHeader header;
+    if (size_bytes < sizeof(header)) {
+        TT_THROW("FreeListOpt blob is truncated: {} B is smaller than the header", size_bytes);
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, "TTFS", 4) != 0) {
+        TT_THROW("Not a FreeListOpt blob");
+    }
+    if (header.version != serialized_version) {
+        TT_THROW("FreeListOpt blob version {} is not supported (expected {})", header.version, serialized_version);
+    }
+    if (header.size_bytes != size_bytes || size_bytes % 8 != 0) {
+        TT_THROW("FreeListOpt blob is {} B but its header says {} B", size_bytes, header.size_bytes);
+    }
+    if (checksum_blob(bytes + serialized_checksum_start, size_bytes - serialized_checksum_start) != header.checksum) {
+        TT_THROW("FreeListOpt blob checksum mismatch, the blob is corrupted");
+    }
+    if (header.max_size_bytes + header.shrink_size != max_size_bytes_ + shrink_size_ ||
+        header.offset_bytes != offset_bytes_ || header.min_allocation_size != min_allocation_size_ ||
+        header.alignment != alignment_) {
+        TT_THROW(
+            "FreeListOpt blob is for a {} B bank at {} with {} B minimum allocation size and {} B alignment, this "
+            "allocator has a {} B bank at {} with {} B and {} B",
+            header.max_size_bytes + header.shrink_size,
+            header.offset_bytes,
+            header.min_allocation_size,
+            header.alignment,
+            max_size_bytes_ + shrink_size_,
+            offset_bytes_,
+            min_allocation_size_,
+            alignment_);
+    }
+    if (bool(header.flags & serialized_compact_layout) != compact_layout_) {
+        TT_THROW("FreeListOpt blob uses a different metadata layout than this allocator");
+    }
+    if (header.n_alloc_table_buckets != n_alloc_table_buckets ||
+        (header.n_quick_lists != 0 && header.n_quick_lists != n_quick_lists)) {
+        TT_THROW("FreeListOpt blob has an unexpected table layout");
+    }
+
+    // Read everything before touching the allocator, so a bad blob leaves it as it was
+    BlobReader reader(bytes, size_bytes);
+    std::vector<DeviceAddr> size_classes;
+    reader.read_array(size_classes, header.n_size_classes);
+    std::vector<CompactBlock> compact_blocks;
+    std::vector<DeviceAddr> block_addresses, block_sizes;
+    std::vector<ssize_t> block_prev_blocks, block_next_blocks;
+    std::vector<uint8_t> block_is_allocated, meta_block_is_allocated;
+    if (compact_layout_) {
+        reader.read_array(compact_blocks, header.n_slots);
+    } else {
+        reader.read_array(block_addresses, header.n_slots);
+        reader.read_array(block_sizes, header.n_slots);
+        reader.read_array(block_prev_blocks, header.n_slots);
+        reader.read_array(block_next_blocks, header.n_slots);
+        reader.read_array(block_is_allocated, header.n_slots);
+    }
+    reader.read_array(meta_block_is_allocated, header.n_slots);
+    std::vector<size_t> unused_slots;
+    reader.read_array(unused_slots, header.n_unused_slots);
+
+    auto read_lists = [&reader](auto& lists, size_t n_lists) {
+        std::vector<uint64_t> list_sizes;
+        reader.read_array(list_sizes, n_lists);
+        lists.resize(n_lists);
+        for (size_t i = 0; i < n_lists; i++) {
+            reader.read_array(lists[i], list_sizes[i]);
+        }
+    };
+    std::vector<std::vector<size_t>> free_blocks;
+    read_lists(free_blocks, header.n_size_classes);
+    std::vector<std::vector<DeviceAddr>> free_block_sizes(header.n_size_classes);
+    for (size_t i = 0; i < header.n_size_classes; i++) {
+        reader.read_array(free_block_sizes[i], free_blocks[i].size());
+    }
+    std::vector<uint64_t> quick_list_sizes;
+    reader.read_array(quick_list_sizes, header.n_quick_lists);
+    std::vector<std::vector<size_t>> quick_list_blocks;
+    read_lists(quick_list_blocks, header.n_quick_lists);
+    std::vector<std::vector<std::pair<DeviceAddr, size_t>>> allocated_block_table;
+    read_lists(allocated_block_table, header.n_alloc_table_buckets);
+    if (!reader.at_end()) {
+        TT_THROW("FreeListOpt blob has trailing data");
+    }
+
+    // The checksum only catches accidental damage, check that every index the blob holds points into its block table
+    // so a malformed blob is rejected here rather than corrupting the allocator once committed
+    const size_t n_slots = header.n_slots;
+    auto check_slot = [n_slots](size_t slot, const char* what) {
+        if (slot >= n_slots) {
+            TT_THROW("FreeListOpt blob has {} {} outside of its {} block slots", what, slot, n_slots);
+        }
+    };
+    auto check_link = [&check_slot](ssize_t link) {
+        if (link != -1) {
+            check_slot(link, "block link");
+        }
+    };
+    if (compact_layout_) {
+        for (const CompactBlock& block : compact_blocks) {
+            check_link(block.prev_block == compact_no_block ? -1 : ssize_t(block.prev_block));
+            check_link(block.next_block == compact_no_block ? -1 : ssize_t(block.next_block));
+        }
+    } else {
+        for (size_t slot = 0; slot < n_slots; slot++) {
+            check_link(block_prev_blocks[slot]);
+            check_link(block_next_blocks[slot]);
+        }
+    }
+    for (size_t slot : unused_slots) {
+        check_slot(slot, "unused slot");
+    }
+    for (const auto& blocks : free_blocks) {
+        for (size_t slot : blocks) {
+            check_slot(slot, "free block");
+        }
+    }
+    for (const auto& blocks : quick_list_blocks) {
+        // Without quick lists here the parked blocks are freed instead, so the depth doesn't apply
+        if (!quick_lists_.empty() && blocks.size() > quick_list_depth_) {
+            TT_THROW(
+                "FreeListOpt blob has a quick list of {} blocks, deeper than the {} allowed",
+                blocks.size(),
+                quick_list_depth_);
+        }
+        for (size_t slot : blocks) {
+            check_slot(slot, "quick list block");
+        }
+    }
+    for (const auto& bucket : allocated_block_table) {
+        for (const auto& [address, slot] : bucket) {
+            check_slot(slot, "allocated block");
+        }
+    }
+
+    max_size_bytes_ = header.max_size_bytes;
+    shrink_size_ = header.shrink_size;
+    clear_tenant_allocations();
+    allocated_bytes_ = header.allocated_bytes;
+    quick_list_bytes_ = header.quick_list_bytes;
+    next_fit_rover_ = header.next_fit_rover;
+    compact_blocks_ = std::move(compact_blocks);
+    block_address_ = std::move(block_addresses);
+    block_size_ = std::move(block_sizes);
+    block_prev_block_ = std::move(block_prev_blocks);
+    block_next_block_ = std::move(block_next_blocks);
+    block_is_allocated_ = std::move(block_is_allocated);
+    meta_block_is_allocated_ = std::move(meta_block_is_allocated);
+    free_meta_block_indices_ = std::move(unused_slots);
+    allocated_block_table_ = std::move(allocated_block_table);
+
+    bool same_size_classes = size_classes == size_class_lower_bounds_ &&
+                             bool(header.flags & serialized_size_ordered_classes) == size_ordered_classes_;
+    if (same_size_classes) {
+        free_blocks_segregated_by_size_ = std::move(free_blocks);
+        free_block_sizes_segregated_by_size_ = std::move(free_block_sizes);
+    } else {
+        rebuild_segregated_lists();
+    }
+
+    for (auto& quick_list : quick_lists_) {
+        quick_list.size = 0;
+        quick_list.blocks.clear();
+    }
+    if (!quick_lists_.empty()) {
+        for (size_t slot = 0; slot < header.n_quick_lists; slot++) {
+            quick_lists_[slot].size = quick_list_sizes[slot];
+            quick_lists_[slot].blocks = std::move(quick_list_blocks[slot]);
+        }
+    } else {
+        // No quick lists here, return the parked blocks to the free list
+        for (const auto& blocks : quick_list_blocks) {
+            for (size_t block_index : blocks) {
+                release_quick_list_block(block_index);
+            }
+        }
+    }
+    maybe_validate();
+    check_watermarks();
+}
+
 void FreeListOpt::shrink_size(DeviceAddr shrink_size, bool bottom_up) {
     if (shrink_size == 0) {
         return;
     }
+    flush_quick_lists();
     TT_FATAL(bottom_up, "Shrinking from the top is currently not supported");
+    TT_FATAL(
+        !compact_layout_ || shrink_size % alignment_ == 0,
+        "Shrink size {} should be {} B aligned with the compact metadata layout",
+        shrink_size,
+        alignment_);
     TT_FATAL(
         shrink_size <= this->max_size_bytes_,
         "Shrink size {} must be smaller than max size {}",
@@ -439,16 +2013,16 @@ void FreeListOpt::shrink_size(DeviceAddr shrink_size, bool bottom_up) {
     size_t block_to_shrink = -1;
     DeviceAddr shrunk_address = shrink_size_ + shrink_size;
     // TODO: There must be a way to force the beginning of all blocks be at index 0
-    for (size_t i = 0; i < block_address_.size(); i++) {
+    for (size_t i = 0; i < block_table_size(); i++) {
         if (!meta_block_is_allocated_[i]) {
             continue;
-        } else if (block_is_allocated_[i]) {
+        } else if (block_is_allocated(i)) {
             TT_FATAL(
-                block_address_[i] >= shrunk_address,
+                block_address(i) >= shrunk_address,
                 "Shrink size {} cuts into allocated block at address {}",
                 shrunk_address,
-                block_address_[i]);
-        } else if (block_address_[i] <= shrunk_address && block_address_[i] + block_size_[i] >= shrunk_address) {
+                block_address(i));
+        } else if (block_address(i) <= shrunk_address && block_address(i) + block_size(i) >= shrunk_address) {
             block_to_shrink = i;
             break;
         }
@@ -456,41 +2030,38 @@ void FreeListOpt::shrink_size(DeviceAddr shrink_size, bool bottom_up) {
 
     TT_FATAL(block_to_shrink != -1, "Shrink size {} does not align with any block. This must be a bug", shrunk_address);
 
-    // Find the relevant size segregated list
-    size_t size_segregated_index = get_size_segregated_index(block_size_[block_to_shrink]);
-    std::vector<size_t>& segregated_list = free_blocks_segregated_by_size_[size_segregated_index];
-    for (size_t i = 0; i < segregated_list.size(); i++) {
-        if (segregated_list[i] == block_to_shrink) {
-            segregated_list.erase(segregated_list.begin() + i);
-            break;
-        }
-    }
+    remove_block_from_segregated_list(block_to_shrink);
 
     // Shrink the block
-    block_size_[block_to_shrink] -= shrink_size;
+    set_block_size(block_to_shrink, block_size(block_to_shrink) - shrink_size);
     max_size_bytes_ -= shrink_size;
     shrink_size_ += shrink_size;
-    if (block_size_[block_to_shrink] == 0) {
-        block_prev_block_[block_next_block_[block_to_shrink]] = block_prev_block_[block_to_shrink];
+    if (block_size(block_to_shrink) == 0) {
+        if (block_next_block(block_to_shrink) != -1) {
+            set_block_prev_block(block_next_block(block_to_shrink), block_prev_block(block_to_shrink));
+        }
         free_meta_block(block_to_shrink);
     } else {
-        block_address_[block_to_shrink] += shrink_size;
+        set_block_address(block_to_shrink, block_address(block_to_shrink) + shrink_size);
         insert_block_to_segregated_list(block_to_shrink);
     }
+    maybe_validate();
+    check_watermarks();
 }
 
 void FreeListOpt::reset_size() {
     if (shrink_size_ == 0) {
         return;
     }
+    flush_quick_lists();
 
     // Create a new block, mark it as allocated and deallocate the old block so coalescing can happen
     ssize_t lowest_block_index = -1;
-    for (size_t i = 0; i < block_address_.size(); i++) {
+    for (size_t i = 0; i < block_table_size(); i++) {
         if (!meta_block_is_allocated_[i]) {
             continue;
         }
-        if (block_address_[i] == shrink_size_) {
+        if (block_address(i) == shrink_size_) {
             lowest_block_index = i;
             break;
         }
@@ -500,32 +2071,35 @@ void FreeListOpt::reset_size() {
     // There 2 cases to consider:
     // 1. The lowest block is is free, which means we can just modify it's attributes
     // 2. The lowest block is allocated, which means we need to create a new block and deallocate the old one
-    if (!block_is_allocated_[lowest_block_index]) {
-        auto* segregated_list =
-            &free_blocks_segregated_by_size_[get_size_segregated_index(block_size_[lowest_block_index])];
-        for (size_t i = 0; i < segregated_list->size(); i++) {
-            if ((*segregated_list)[i] == lowest_block_index) {
-                segregated_list->erase(segregated_list->begin() + i);
-                break;
-            }
-        }
-        block_size_[lowest_block_index] += shrink_size_;
-        block_address_[lowest_block_index] = 0;
+    if (!block_is_allocated(lowest_block_index)) {
+        remove_block_from_segregated_list(lowest_block_index);
+        set_block_size(lowest_block_index, block_size(lowest_block_index) + shrink_size_);
+        set_block_address(lowest_block_index, 0);
         insert_block_to_segregated_list(lowest_block_index);
     } else {
         size_t new_block_index = alloc_meta_block(0, shrink_size_, -1, lowest_block_index, false);
-        TT_ASSERT(block_prev_block_[lowest_block_index] == -1, "Lowest block should not have a previous block");
-        block_prev_block_[lowest_block_index] = new_block_index;
+        TT_ASSERT(block_prev_block(lowest_block_index) == -1, "Lowest block should not have a previous block");
+        set_block_prev_block(lowest_block_index, new_block_index);
         insert_block_to_segregated_list(new_block_index);
     }
 
     max_size_bytes_ += shrink_size_;
     shrink_size_ = 0;
+    maybe_validate();
+    check_watermarks();
 }
 
 void FreeListOpt::insert_block_to_segregated_list(size_t block_index) {
-    const size_t size_segregated_index = get_size_segregated_index(block_size_[block_index]);
+    const size_t size_segregated_index = get_size_segregated_index(block_size(block_index));
     auto& free_blocks = free_blocks_segregated_by_size_[size_segregated_index];
+    auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_segregated_index];
+    if (size_ordered_classes_) {
+        size_t position =
+            size_ordered_position(size_segregated_index, block_size(block_index), block_address(block_index));
+        free_block_sizes.insert(free_block_sizes.begin() + position, block_size(block_index));
+        free_blocks.insert(free_blocks.begin() + position, block_index);
+        return;
+    }
     // Pushing to the back is faster than sorted insertion. But it increases fragmentation
     // free_blocks.push_back(block_index);
     // The overhead is not worth it in benchmarks. Need real world data to confirm. But certainly it'll help with
@@ -534,18 +2108,62 @@ void FreeListOpt::insert_block_to_segregated_list(size_t block_index) {
     // from experience, the lower bound is only faster after a certain number of elements
     if (free_blocks.size() < 30) {
         for (it = free_blocks.begin(); it != free_blocks.end(); it++) {
-            if (block_address_[*it] > block_address_[block_index]) {
+            if (block_address(*it) > block_address(block_index)) {
                 break;
             }
         }
     } else {
         it = std::lower_bound(free_blocks.begin(), free_blocks.end(), block_index, [this](size_t a, size_t b) {
-            return block_address_[a] < block_address_[b];
+            return block_address(a) < block_address(b);
         });
     }
+    free_block_sizes.insert(free_block_sizes.begin() + (it - free_blocks.begin()), block_size(block_index));
     free_blocks.insert(it, block_index);
 }
 
+void FreeListOpt::remove_block_from_segregated_list(size_t block_index) {
+    const size_t size_segregated_index = get_size_segregated_index(block_size(block_index));
+    const auto& free_blocks = free_blocks_segregated_by_size_[size_segregated_index];
+    if (size_ordered_classes_) {
+        size_t position =
+            size_ordered_position(size_segregated_index, block_size(block_index), block_address(block_index));
+        TT_ASSERT(
+            position < free_blocks.size() && free_blocks[position] == block_index,
+            "Block {} not found in size segregated list",
+            block_index);
+        erase_from_segregated_list({size_segregated_index, position});
+        return;
+    }
+    auto it = std::find(free_blocks.begin(), free_blocks.end(), block_index);
+    TT_ASSERT(it != free_blocks.end(), "Block {} not found in size segregated list", block_index);
+    erase_from_segregated_list({size_segregated_index, size_t(it - free_blocks.begin())});
+}
+
+size_t FreeListOpt::size_ordered_position(size_t size_class, DeviceAddr size, DeviceAddr address) const {
+    const auto& free_blocks = free_blocks_segregated_by_size_[size_class];
+    const auto& free_block_sizes = free_block_sizes_segregated_by_size_[size_class];
+    // Binary search the contiguous sizes first, then the (usually few) blocks of the same size by address
+    auto [first, last] = std::equal_range(free_block_sizes.begin(), free_block_sizes.end(), size);
+    size_t lo = first - free_block_sizes.begin();
+    size_t hi = last - free_block_sizes.begin();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (block_address(free_blocks[mid]) < address) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void FreeListOpt::erase_from_segregated_list(SegregatedListPosition position) {
+    auto& free_blocks = free_blocks_segregated_by_size_[position.size_class];
+    auto& free_block_sizes = free_block_sizes_segregated_by_size_[position.size_class];
+    free_blocks.erase(free_blocks.begin() + position.index);
+    free_block_sizes.erase(free_block_sizes.begin() + position.index);
+}
+
 inline size_t FreeListOpt::hash_device_address(DeviceAddr address) {
     // HACK: This hash is critical for performance, empirically found to be good for
     // the specific usecase
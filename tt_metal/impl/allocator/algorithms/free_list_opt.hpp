@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <vector>
 #include <optional>
+#include <string>
+#include <unordered_map>
 
 #include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
 
@@ -17,19 +22,159 @@ namespace allocator {
 // - Hash table to store allocated blocks for faster block lookup during deallocation
 // - Keeps metadata locality to avoid cache misses
 // - Metadata reuse to avoid allocations
-class FreeListOpt : public Algorithm {
+class FreeListOpt final : public Algorithm {
 public:
+    // Layout of the block metadata. WIDE keeps every field in its own vector of 64 bit values and works for any bank.
+    // COMPACT packs a block into 16 bytes (32 bit indices, address and size in units of the alignment with the
+    // allocated bit folded into the size), so looking at a neighbour during coalescing touches one cache line instead
+    // of five, and a device with hundreds of bank allocators uses a fraction of the host memory. COMPACT requires
+    // the bank size in alignment units to fit in 31 bits and addresses passed in to be aligned
+    enum class MetadataLayout : uint8_t {
+        WIDE = 0,
+        COMPACT = 1,
+        AUTO = 2,  // COMPACT if the bank fits, WIDE otherwise
+    };
+    // Order of the free blocks within a size class. ADDRESS order makes best fit a linear (SIMD) scan of the class.
+    // SIZE keeps each class ordered by (size, address) so the tightest fit is a binary search and removing a block
+    // doesn't need a scan. Both pick the same blocks, SIZE is faster when classes hold many blocks
+    enum class SizeClassOrder : uint8_t {
+        ADDRESS = 0,
+        SIZE = 1,
+    };
+    // How a block is picked within a size class. Classes are always walked from the request's class up, so the policy
+    // only decides which fitting block of the first class with a fit is used.
+    // - BEST: the smallest fitting block (the tightest fit overall)
+    // - FIRST: the first fitting block in the walk direction
+    // - NEXT: the first fitting block at or after the end of the previous allocation, wrapping around (roving pointer)
+    // - GOOD_ENOUGH: the first block in the walk direction that is at most good_enough_slack larger than the request,
+    //   else the best fit
+    // Policies other than BEST need ADDRESS ordered classes (SIZE order finds the best fit by binary search anyway)
+    enum class SearchPolicy : uint8_t {
+        BEST = 0,
+        FIRST = 1,
+        NEXT = 2,
+        GOOD_ENOUGH = 3,
+    };
+    struct Options {
+        MetadataLayout metadata_layout = MetadataLayout::WIDE;
+        SizeClassOrder size_class_order = SizeClassOrder::ADDRESS;
+        // Size classes. By default every power of two from size_class_base up is a class, and everything below
+        // 2 * size_class_base shares class 0. size_class_subdivisions splits each power of two into that many
+        // classes (like TLSF's second level). size_classes, if not empty, is an explicit table of class lower bounds
+        // starting at 0 and overrides the other two (see size_classes_from_histogram). Placement does not depend on
+        // the classes, only how many blocks an allocation has to look at does. Banks with mostly small buffers (L1)
+        // want a small base or a table, else everything lands in class 0
+        DeviceAddr size_class_base = 1024;
+        size_t size_class_subdivisions = 1;
+        std::vector<DeviceAddr> size_classes = {};
+        // Quick lists. Freed blocks up to quick_list_max_size bytes are parked on a list per exact size instead of
+        // being coalesced, so allocating a recently freed size again pops a block in a handful of instructions. Up to
+        // quick_list_depth blocks are kept per size (0 disables quick lists). Parked blocks are coalesced when their
+        // list overflows, when an allocation would otherwise fail, or before operations that need the exact free list
+        // (allocate_at_address, shrink_size, ...). They skip best fit placement, trading some fragmentation for speed
+        size_t quick_list_depth = 0;
+        DeviceAddr quick_list_max_size = 64 * 1024;
+        SearchPolicy search_policy = SearchPolicy::BEST;
+        double good_enough_slack = 0.125;  // GOOD_ENOUGH accepts blocks up to request * (1 + slack)
+        // Run validate() after every operation that changes the heap. Slow (linear in the number of blocks), meant for
+        // staging and debugging. Always on when built with TT_ALLOC_VALIDATE
+        bool validate = false;
+    };
+
     FreeListOpt(
         DeviceAddr max_size_bytes, DeviceAddr offset_bytes, DeviceAddr min_allocation_size, DeviceAddr alignment);
+    FreeListOpt(
+        DeviceAddr max_size_bytes,
+        DeviceAddr offset_bytes,
+        DeviceAddr min_allocation_size,
+        DeviceAddr alignment,
+        const Options& options);
     void init() override;
 
+    // Ranges are in size class order (ascending classes, each in its list's order), only visiting the classes that can
+    // hold size_bytes. While blocks are parked on the quick lists they are in address order instead
     std::vector<std::pair<DeviceAddr, DeviceAddr>> available_addresses(DeviceAddr size_bytes) const override;
 
+    // Allocation free alternatives to available_addresses for repeated queries (ex: searching for an address free in
+    // every bank). They report the same ranges, (start, end) relative to the bank, but always in address order, not in
+    // available_addresses' size class order. Blocks parked on the quick lists count as free. They walk the block list
+    // from the head, allocated blocks included, so they only save the vector: a call costs up to the whole block list
+    // even when few ranges fit, where available_addresses only visits the free blocks of classes that can fit. The
+    // first writes at most capacity ranges to out and returns how many it wrote, with a capacity of 1 it returns the
+    // lowest fitting range and stops there, after walking every block below it. The second calls visitor(start, end)
+    // for each range until it returns false
+    size_t available_addresses(DeviceAddr size_bytes, std::pair<DeviceAddr, DeviceAddr>* out, size_t capacity) const;
+    template <typename Visitor>
+    void for_each_available_address(DeviceAddr size_bytes, Visitor&& visitor) const {
+        const DeviceAddr alloc_size = get_alloc_size(size_bytes);
+        DeviceAddr start = 0;
+        DeviceAddr end = 0;  // Range being merged, empty if start == end
+        for (ssize_t i = find_head_block(); i != -1; i = block_next_block(i)) {
+            if (block_is_allocated(i) && meta_block_is_allocated_[i] != meta_block_in_quick_list) {
+                if (end > start && end - start >= alloc_size && !visitor(start, end)) {
+                    return;
+                }
+                start = end = 0;
+                continue;
+            }
+            if (start == end) {
+                start = block_address(i);
+            }
+            end = block_address(i) + block_size(i);
+        }
+        if (end > start && end - start >= alloc_size) {
+            visitor(start, end);
+        }
+    }
+
+    // Lowest (bottom_up) or highest address, relative to the bank, where size_bytes is free in every one of banks. This
+    // is the address an interleaved buffer can be placed at with allocate_at_address in each bank. The banks' free
+    // ranges are swept together in address order, each bank only moving forward past ranges that can't hold the
+    // current candidate, and the sweep stops as soon as every bank agrees. Parked blocks count as free, same as
+    // available_addresses. The banks must have the same alignment
+    static std::optional<DeviceAddr> find_common_free_address(
+        const std::vector<const FreeListOpt*>& banks, DeviceAddr size_bytes, bool bottom_up = true);
+
     std::optional<DeviceAddr> allocate(
         DeviceAddr size_bytes, bool bottom_up = true, DeviceAddr address_limit = 0) override;
 
+    // Placement hints. Short lived buffers (temporaries, scratch) are placed at the top of the heap and long lived ones
+    // (weights, persistent buffers) at the bottom, so freeing temporaries leaves large holes instead of small ones
+    // trapped between weights. affinity_address asks for the free block closest to an existing buffer, so buffers used
+    // together by the same kernel land next to each other. It takes precedence over lifetime when picking the end of
+    // the block to allocate from
+    enum class Lifetime : uint8_t { LONG = 0, SHORT = 1 };
+    struct AllocationHint {
+        Lifetime lifetime = Lifetime::LONG;
+        std::optional<DeviceAddr> affinity_address = std::nullopt;  // absolute address
+    };
+    std::optional<DeviceAddr> allocate(
+        DeviceAddr size_bytes, const AllocationHint& hint, DeviceAddr address_limit = 0);
+
     std::optional<DeviceAddr> allocate_at_address(DeviceAddr absolute_start_address, DeviceAddr size_bytes) override;
 
+    // Tenants share the bank (no partitioning) but each has a quota on the bytes it holds. Allocations made through
+    // the *_for_tenant calls are charged to the tenant until deallocated, and fail without searching if they would
+    // take the tenant over its quota (on_oom is not called for those). Other allocations are not charged to anyone.
+    // Usage is reported in Statistics::tenants. Charges are dropped by clear() and deserialize(). With no tenant
+    // allocation live the only cost is one branch in deallocate
+    using TenantId = uint32_t;
+    inline static constexpr DeviceAddr unlimited_quota = std::numeric_limits<DeviceAddr>::max();
+    TenantId add_tenant(std::string name, DeviceAddr quota_bytes = unlimited_quota);
+    void set_tenant_quota(TenantId tenant, DeviceAddr quota_bytes);
+    std::optional<DeviceAddr> allocate_for_tenant(
+        TenantId tenant, DeviceAddr size_bytes, bool bottom_up = true, DeviceAddr address_limit = 0);
+    std::optional<DeviceAddr> allocate_at_address_for_tenant(
+        TenantId tenant, DeviceAddr absolute_start_address, DeviceAddr size_bytes);
+
+    // Bulk version of allocate_at_address for committing precomputed layouts. Takes (absolute address, size) pairs and
+    // returns the result of each request in the same order. Requests are sorted and the block list is swept once, so
+    // the cost is linear in the number of blocks instead of a full scan per request. If requests overlap each other,
+    // the one at the lower address wins. Of requests at the same address the earlier one in requests wins, as it
+    // would when calling allocate_at_address for each in order
+    std::vector<std::optional<DeviceAddr>> allocate_at_addresses(
+        const std::vector<std::pair<DeviceAddr, DeviceAddr>>& requests);
+
     void deallocate(DeviceAddr absolute_address) override;
 
     void clear() override;
@@ -38,10 +183,119 @@ public:
 
     void dump_blocks(std::ostream& out) const override;
 
+    // Machine readable dumps of the allocator state for tooling. TEXT is the table dump_blocks(out) prints. JSON and
+    // BINARY hold the same content: bank parameters, statistics, size classes with their free blocks, quick lists,
+    // unused metadata slots and the blocks in address order. Block addresses are relative to the bank (add
+    // offset_bytes for absolute addresses) and block ids are metadata slot indices. BINARY is host endian:
+    //   header: char[4] "TTFL", uint32 version (1), uint64 max_size_bytes, offset_bytes, alignment, shrink_size,
+    //           total_allocated_bytes, total_free_bytes, largest_free_block_bytes
+    //   uint64 n_size_classes, then per class: uint64 lower_bound, uint64 n, n x uint64 block id
+    //   uint64 n_quick_lists (non-empty only), then per list: uint64 size, uint64 n, n x uint64 block id
+    //   uint64 n_unused_slots, n x uint64 slot index
+    //   uint64 n_blocks, n x 48 byte records (uint64 id, address, size, int64 prev, next, uint8 state, 7 pad bytes)
+    //   with state 0 = free, 1 = allocated, 2 = parked on a quick list and prev/next -1 for none
+    enum class DumpFormat : uint8_t {
+        TEXT = 0,
+        JSON = 1,
+        BINARY = 2,
+    };
+    void dump_blocks(std::ostream& out, DumpFormat format) const;
+
+    // A block as seen by for_each_block
+    struct BlockView {
+        size_t id;           // metadata slot index, what prev_block and next_block refer to
+        DeviceAddr address;  // relative to the bank
+        DeviceAddr size;
+        ssize_t prev_block;  // -1 for none
+        ssize_t next_block;  // -1 for none
+        bool is_allocated;
+        bool in_quick_list;  // freed but parked on a quick list (is_allocated is true for these)
+    };
+    // Call callback(const BlockView&) for every block in address order, without allocating
+    template <typename Callback>
+    void for_each_block(Callback&& callback) const {
+        for (ssize_t i = find_head_block(); i != -1; i = block_next_block(i)) {
+            callback(BlockView{
+                .id = size_t(i),
+                .address = block_address(i),
+                .size = block_size(i),
+                .prev_block = block_prev_block(i),
+                .next_block = block_next_block(i),
+                .is_allocated = block_is_allocated(i),
+                .in_quick_list = meta_block_is_allocated_[i] == meta_block_in_quick_list,
+            });
+        }
+    }
+
+    // Warm start. serialize() saves the whole heap (block table, size classes, quick lists and the allocated block
+    // table) to a versioned, checksummed, host endian blob made of 8 byte aligned arrays, so it can be written to a
+    // file and later passed to deserialize() straight from an mmap of it. deserialize() replaces the state of this
+    // allocator with the blob's using bulk copies, instead of replaying allocate_at_address for every block. The
+    // allocator must have the same bank size, offset, minimum allocation size, alignment and metadata layout as the
+    // one that was saved. Size classes and class order may differ, the classes are rebuilt then. Callbacks and
+    // options are not part of the blob. Throws std::runtime_error, leaving the allocator untouched, if the blob is
+    // truncated, corrupted, from another version or doesn't match, if it references block slots it doesn't have, or
+    // if its quick lists are deeper than this allocator's quick_list_depth
+    std::vector<uint8_t> serialize() const;
+    void deserialize(const void* data, size_t size_bytes);
+
     void shrink_size(DeviceAddr shrink_size, bool bottom_up = true) override;
 
     void reset_size() override;
 
+    // Renumber the live blocks contiguously in address order and release the memory held by unused metadata slots.
+    // Runs automatically during deallocation once enough slots are dead, but can be called explicitly after a burst
+    // of fragmentation (ex: when a program finishes and frees all its buffers)
+    void compact_metadata();
+
+    // Host memory used by the allocator's metadata, in bytes
+    size_t metadata_memory_bytes() const;
+
+    // Coalesce every block parked on the quick lists back into the free list
+    void flush_quick_lists();
+
+    // Memory pressure hooks. Both are unset by default and cost nothing then
+    struct OutOfMemoryEvent {
+        DeviceAddr size_bytes;  // as requested
+        DeviceAddr alloc_size;  // after applying the minimum allocation size and alignment
+        Statistics statistics;
+        // 1 - largest free block / free bytes. Near 0 when the bank is simply full, near 1 when free memory is there
+        // but too fragmented for the request
+        double external_fragmentation;
+    };
+    // Called when allocate() finds no block for a request. The callback can free buffers (deallocate is safe to call
+    // from it) and returns true to have the allocation retried once. Allocations failing while the callback runs or
+    // during the retry don't call it again. Pass nullptr to unset
+    using OutOfMemoryCallback = std::function<bool(const OutOfMemoryEvent&)>;
+    void set_on_oom(OutOfMemoryCallback callback);
+
+    enum class Watermark : uint8_t {
+        LOW = 0,   // free bytes dropped below the low watermark
+        HIGH = 1,  // free bytes rose above the high watermark after being below the low one
+    };
+    // Called when free bytes cross the watermarks, with the free bytes after the operation that crossed them. The gap
+    // between the two avoids firing on every allocation near a single threshold. Fires LOW right away if free bytes are
+    // already below low_free_bytes. The callback can allocate and deallocate. Pass nullptr to unset
+    using WatermarkCallback = std::function<void(Watermark, DeviceAddr free_bytes)>;
+    void set_watermarks(DeviceAddr low_free_bytes, DeviceAddr high_free_bytes, WatermarkCallback callback);
+
+    // Check the internal invariants of the heap: block list linkage, blocks covering the bank contiguously, no adjacent
+    // free blocks, every free block in its size class exactly once, the allocated block table matching the allocated
+    // blocks and the quick lists matching the parked blocks. Throws std::runtime_error describing the first violation
+    void validate() const;
+
+    MetadataLayout metadata_layout() const { return compact_layout_ ? MetadataLayout::COMPACT : MetadataLayout::WIDE; }
+
+    // Lower bounds of the size classes in use
+    const std::vector<DeviceAddr>& size_classes() const { return size_class_lower_bounds_; }
+
+    // Derive a size class table from a recorded histogram of allocation sizes ((size, count) pairs). Class boundaries
+    // are placed at the quantiles of the histogram so every class sees about the same number of allocations, which
+    // minimizes the expected number of blocks scanned per allocation. The last class holds everything larger than
+    // the largest recorded size
+    static std::vector<DeviceAddr> size_classes_from_histogram(
+        const std::vector<std::pair<DeviceAddr, size_t>>& histogram, size_t n_classes);
+
 private:
     // SoA free list components
     std::vector<DeviceAddr> block_address_;
@@ -49,10 +303,30 @@ private:
     std::vector<ssize_t> block_prev_block_;
     std::vector<ssize_t> block_next_block_;
     std::vector<uint8_t> block_is_allocated_;       // not using bool to avoid compacting
-    std::vector<uint8_t> meta_block_is_allocated_;  // not using bool to avoid compacting
+    std::vector<uint8_t> meta_block_is_allocated_;  // not using bool to avoid compacting (used by both layouts)
+    // Value of meta_block_is_allocated_ for live blocks parked on a quick list. They are still marked allocated in the
+    // block table so neighbours don't coalesce with them, but no longer in the allocated block table
+    inline static constexpr uint8_t meta_block_in_quick_list = 2;
+
+    // Compact layout components, see MetadataLayout. Only one of the layouts is populated
+    struct CompactBlock {
+        uint32_t address;     // in units of alignment
+        uint32_t size;        // in units of alignment, the top bit is the allocated flag
+        uint32_t prev_block;  // compact_no_block for none
+        uint32_t next_block;  // compact_no_block for none
+    };
+    static_assert(sizeof(CompactBlock) == 16, "CompactBlock should be 16 bytes");
+    inline static constexpr uint32_t compact_no_block = UINT32_MAX;
+    inline static constexpr uint32_t compact_allocated_bit = uint32_t{1} << 31;
+    bool compact_layout_ = false;
+    std::vector<CompactBlock> compact_blocks_;
 
     // Metadata block indices that is not currently used (to reuse blocks instead of always allocating new ones)
     std::vector<size_t> free_meta_block_indices_;
+    // Slots are recycled but the SoA vectors never shrink on their own. Once more than this ratio of slots are unused
+    // (and there are enough of them for it to matter) scans are mostly iterating dead slots, so compact the table
+    inline static constexpr size_t metadata_compaction_min_dead_blocks = 1024;
+    inline static constexpr double metadata_compaction_dead_ratio = 0.5;
 
     // Caches so most operations don't need to scan the entire free list. The allocated block table
     // will not rehash as I find the cost to not be worth it
@@ -67,35 +341,242 @@ private:
 
     // Size class index is calculated by taking the log2 of the block size divided by the base size
     // ex: size = 2048, base = 1024, log2(2048/1024) = 1, so size class index = 1
-    inline static constexpr size_t size_segregated_base = 1024;  // in bytes
-    const size_t size_segregated_count;                          // Number of size classes
+    // Other tables (see Options) are looked up with a binary search over the lower bounds
+    std::vector<DeviceAddr> size_class_lower_bounds_;
+    size_t size_segregated_count;             // Number of size classes
+    bool power_of_two_size_classes_ = false;  // Classes are plain powers of two of a power of two base
+    size_t size_segregated_base_shift_ = 0;   // log2 of the base if power_of_two_size_classes_
+    // Algorithm::align() and the compact layout divide by the alignment. Almost every bank has a power of two
+    // alignment, for which a mask and a shift do the same
+    bool power_of_two_alignment_ = false;
+    DeviceAddr alignment_mask_ = 0;  // alignment_ - 1 if power_of_two_alignment_
+    size_t alignment_shift_ = 0;     // log2 of the alignment if power_of_two_alignment_
     std::vector<std::vector<size_t>> free_blocks_segregated_by_size_;
+    // Sizes of the blocks in free_blocks_segregated_by_size_, in the same order. Best fit search only looks at sizes,
+    // keeping them contiguous avoids an indirection per block and lets the search run as a SIMD min-reduction
+    std::vector<std::vector<DeviceAddr>> free_block_sizes_segregated_by_size_;
+    // See SizeClassOrder
+    bool size_ordered_classes_ = false;
+    // See SearchPolicy
+    SearchPolicy search_policy_ = SearchPolicy::BEST;
+    double good_enough_slack_ = 0;
+    DeviceAddr next_fit_rover_ = 0;  // End of the last allocation, where NEXT starts searching
+
+    // Quick lists (see Options). Direct mapped by size, a slot holds the parked blocks of one size at a time, oldest
+    // first. A different size hashing to an occupied slot flushes it
+    inline static constexpr size_t n_quick_lists = 64;
+    struct QuickList {
+        DeviceAddr size = 0;
+        std::vector<size_t> blocks;
+    };
+    std::vector<QuickList> quick_lists_;
+    size_t quick_list_depth_ = 0;
+    DeviceAddr quick_list_max_size_ = 0;
+    DeviceAddr quick_list_bytes_ = 0;  // Total size of the parked blocks
+
+    bool validate_after_each_operation_ = false;  // See Options::validate
+
+    // Memory pressure hooks, see set_on_oom and set_watermarks
+    DeviceAddr allocated_bytes_ = 0;  // Parked blocks count as free
+    OutOfMemoryCallback on_oom_;
+    bool in_on_oom_ = false;  // on_oom_ or the retry after it is running
+    WatermarkCallback on_watermark_;
+    DeviceAddr low_watermark_ = 0;
+    DeviceAddr high_watermark_ = 0;
+    bool below_low_watermark_ = false;
+
+    // Tenants, see add_tenant
+    std::vector<TenantStatistics> tenants_;
+    std::unordered_map<DeviceAddr, TenantId> tenant_allocations_;  // absolute address -> tenant charged for it
+    // Whether alloc_size more bytes would take the tenant over its quota, counting the refusal if so
+    bool refuse_over_quota(TenantId tenant, DeviceAddr alloc_size);
+    // Charge an allocation (or nothing if it failed) to a tenant
+    void charge_tenant(TenantId tenant, std::optional<DeviceAddr> absolute_address, DeviceAddr alloc_size);
+    // Give a deallocated tenant allocation back to its tenant
+    void release_tenant_allocation(DeviceAddr absolute_address, DeviceAddr alloc_size);
+    void clear_tenant_allocations();
+
+    uint32_t to_alignment_units(DeviceAddr bytes) const {
+        return uint32_t(power_of_two_alignment_ ? bytes >> alignment_shift_ : bytes / alignment_);
+    }
+
+    // Accessors for the block metadata. All code goes through these so it doesn't care about the layout. The layout
+    // never changes after construction so the branch is always predicted
+    size_t block_table_size() const { return meta_block_is_allocated_.size(); }
+    DeviceAddr block_address(size_t block_index) const {
+        if (compact_layout_) {
+            return DeviceAddr{compact_blocks_[block_index].address} * alignment_;
+        }
+        return block_address_[block_index];
+    }
+    DeviceAddr block_size(size_t block_index) const {
+        if (compact_layout_) {
+            return DeviceAddr{compact_blocks_[block_index].size & ~compact_allocated_bit} * alignment_;
+        }
+        return block_size_[block_index];
+    }
+    ssize_t block_prev_block(size_t block_index) const {
+        if (compact_layout_) {
+            uint32_t prev_block = compact_blocks_[block_index].prev_block;
+            return prev_block == compact_no_block ? -1 : ssize_t{prev_block};
+        }
+        return block_prev_block_[block_index];
+    }
+    ssize_t block_next_block(size_t block_index) const {
+        if (compact_layout_) {
+            uint32_t next_block = compact_blocks_[block_index].next_block;
+            return next_block == compact_no_block ? -1 : ssize_t{next_block};
+        }
+        return block_next_block_[block_index];
+    }
+    bool block_is_allocated(size_t block_index) const {
+        if (compact_layout_) {
+            return compact_blocks_[block_index].size & compact_allocated_bit;
+        }
+        return block_is_allocated_[block_index];
+    }
+    void set_block_address(size_t block_index, DeviceAddr address) {
+        if (compact_layout_) {
+            compact_blocks_[block_index].address = to_alignment_units(address);
+        } else {
+            block_address_[block_index] = address;
+        }
+    }
+    void set_block_size(size_t block_index, DeviceAddr size) {
+        if (compact_layout_) {
+            uint32_t& packed = compact_blocks_[block_index].size;
+            packed = (packed & compact_allocated_bit) | to_alignment_units(size);
+        } else {
+            block_size_[block_index] = size;
+        }
+    }
+    void set_block_prev_block(size_t block_index, ssize_t prev_block) {
+        if (compact_layout_) {
+            compact_blocks_[block_index].prev_block = prev_block == -1 ? compact_no_block : uint32_t(prev_block);
+        } else {
+            block_prev_block_[block_index] = prev_block;
+        }
+    }
+    void set_block_next_block(size_t block_index, ssize_t next_block) {
+        if (compact_layout_) {
+            compact_blocks_[block_index].next_block = next_block == -1 ? compact_no_block : uint32_t(next_block);
+        } else {
+            block_next_block_[block_index] = next_block;
+        }
+    }
+    void set_block_is_allocated(size_t block_index, bool is_allocated) {
+        if (compact_layout_) {
+            uint32_t& packed = compact_blocks_[block_index].size;
+            packed = is_allocated ? (packed | compact_allocated_bit) : (packed & ~compact_allocated_bit);
+        } else {
+            block_is_allocated_[block_index] = is_allocated;
+        }
+    }
+    // Append a slot to the metadata table
+    void push_block(DeviceAddr address, DeviceAddr size, ssize_t prev_block, ssize_t next_block, bool is_allocated);
+    void clear_block_table();
 
     // internal functions
+    // Location of a free block in the size segregated lists
+    struct SegregatedListPosition {
+        size_t size_class;
+        size_t index;
+    };
+    // Best fit search over the size segregated lists. Without an affinity the first best block found in the walk
+    // direction wins. With an affinity, the fitting block closest to the affinity address in the first size class
+    // that has a fit is picked instead
+    std::optional<SegregatedListPosition> find_free_block(
+        DeviceAddr alloc_size, bool bottom_up, std::optional<DeviceAddr> affinity_address) const;
+    // Index of the block picked by search_policy_ in an address ordered size class, -1 if none fits
+    ssize_t find_first_fit(size_t size_class, DeviceAddr alloc_size, bool bottom_up) const;
+    ssize_t find_next_fit(size_t size_class, DeviceAddr alloc_size) const;
+    ssize_t find_good_enough_fit(size_t size_class, DeviceAddr alloc_size, bool bottom_up) const;
+    // Removes the free block from the segregated list and allocates alloc_size bytes at offset within it. Returns the
+    // absolute address of the allocation
+    DeviceAddr allocate_from_free_block(
+        SegregatedListPosition position, DeviceAddr alloc_size, size_t offset, DeviceAddr address_limit);
+
     // Given a block index, mark a chunk (from block start + offset to block start + offset + alloc_size) as allocated
-    // Unused space is split into a new free block and retuened to the free list and the segregated list
+    // Unused space is split into a new free block and retuened to the free list and the segregated list (unless
+    // update_segregated_list is false, in which case the caller must rebuild the segregated lists)
     // NOTE: This function DOES NOT remove block_index from the segregated list. Caller should do that
-    size_t allocate_in_block(size_t block_index, DeviceAddr alloc_size, size_t offset);
+    size_t allocate_in_block(size_t block_index, DeviceAddr alloc_size, size_t offset, bool update_segregated_list = true);
+
+    // Return a block to the free list, coalescing it with its free neighbours
+    void free_block(size_t block_index);
+
+    static size_t quick_list_slot(DeviceAddr size) { return (size * 0x9E3779B97F4A7C15ull) >> 58; }
+    static_assert(n_quick_lists == 64, "quick_list_slot assumes 64 slots");
+    // Park a freed block on its quick list. Returns false if the block is too large to be cached
+    bool push_to_quick_list(size_t block_index);
+    std::optional<DeviceAddr> allocate_from_quick_list(DeviceAddr alloc_size, DeviceAddr address_limit);
+    // Take a parked block off the quick lists and return it to the free list. Does not remove it from the slot
+    void release_quick_list_block(size_t block_index);
+    // Free ranges (start, end) in address order, treating parked blocks as free and merging adjacent ones
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> free_ranges_with_quick_lists() const;
+    // The next such range from block_index towards higher (forward) or lower addresses. block_index is moved past it,
+    // to -1 at the end of the block list. Returns false if there is no range left
+    bool next_free_range(ssize_t& block_index, bool forward, std::pair<DeviceAddr, DeviceAddr>& range) const;
+
+    // validate() if enabled by Options::validate or TT_ALLOC_VALIDATE
+    void maybe_validate() const;
+
+    // Run on_oom_ for a failed allocation and call retry() if it asks to
+    template <typename Retry>
+    std::optional<DeviceAddr> handle_oom(DeviceAddr size_bytes, DeviceAddr alloc_size, Retry&& retry);
+    // Call on_watermark_ if free bytes crossed a watermark
+    void check_watermarks() {
+        if (on_watermark_) {
+            notify_watermarks();
+        }
+    }
+    void notify_watermarks();
+
+    // Index of the block at the lowest address
+    size_t find_head_block() const;
+    // Index of the block at the highest address
+    size_t find_tail_block() const;
+    // Throw away and rebuild the segregated lists by walking the block list in address order
+    void rebuild_segregated_lists();
+
+    // Aligned size of an allocation of size_bytes. The 16 and 32 B alignments most banks use get their own branch with
+    // the alignment as a constant, other powers of two use the mask and anything else divides
+    inline DeviceAddr get_alloc_size(DeviceAddr size_bytes) const {
+        DeviceAddr size = std::max(size_bytes, min_allocation_size_);
+        switch (alignment_) {
+            case 16: return (size + 15) & ~DeviceAddr{15};
+            case 32: return (size + 31) & ~DeviceAddr{31};
+            default: return power_of_two_alignment_ ? (size + alignment_mask_) & ~alignment_mask_ : align(size);
+        }
+    }
 
     inline size_t get_size_segregated_index(DeviceAddr size_bytes) const {
-        // std::log2 is SLOW, so we use a simple log2 implementation for integers. I assume GCC compiles this to a
-        // count leading zeros instruction then a subtraction.
-        size_t lg = 0;
-        size_t n = size_bytes / size_segregated_base;
-        while (n >>= 1) {
-            lg++;
+        if (power_of_two_size_classes_) {
+            // std::log2 is SLOW, and GCC doesn't turn a shift loop into a count leading zeros instruction
+            size_t n = size_bytes >> size_segregated_base_shift_;
+            size_t lg = n == 0 ? 0 : 63 - __builtin_clzll(n);
+            return std::min(size_segregated_count - 1, lg);
         }
-        return std::min(size_segregated_count - 1, lg);
+        auto it = std::upper_bound(size_class_lower_bounds_.begin(), size_class_lower_bounds_.end(), size_bytes);
+        return (it - size_class_lower_bounds_.begin()) - 1;
     }
     // Put the block at block_index into the size segregated list at the appropriate index (data taken from
     // the SoA vectors)
     void insert_block_to_segregated_list(size_t block_index);
+    // Remove the block at block_index from the size segregated list it is in. The block size must not have changed
+    // since it was inserted
+    void remove_block_from_segregated_list(size_t block_index);
+    void erase_from_segregated_list(SegregatedListPosition position);
+    // Where a block with the given size and address is (or would be inserted) in a size ordered class
+    size_t size_ordered_position(size_t size_class, DeviceAddr size, DeviceAddr address) const;
 
     // Allocate a new block and return the index to the block
     size_t alloc_meta_block(
         DeviceAddr address, DeviceAddr size, ssize_t prev_block, ssize_t next_block, bool is_allocated);
     // Free the block at block_index and mark it as free
     void free_meta_block(size_t block_index);
+    // Run compact_metadata() if the dead slot ratio crossed the threshold
+    void maybe_compact_metadata();
 
     // Operations on the allocated block table
     static size_t hash_device_address(DeviceAddr address);
@@ -0,0 +1,170 @@
+#include "tt_metal/impl/allocator/algorithms/free_list_opt_simd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+namespace simd {
+
+namespace {
+// Below this many blocks the vector setup and the second pass to locate the minimum cost more than they save
+constexpr size_t min_vector_count = 16;
+
+// Second pass once the smallest fitting size is known. Find where it is in the walk direction
+ssize_t locate(const DeviceAddr* sizes, size_t count, DeviceAddr value, bool bottom_up) {
+    if (bottom_up) {
+        for (size_t i = 0; i < count; i++) {
+            if (sizes[i] == value) {
+                return i;
+            }
+        }
+    } else {
+        for (size_t i = count; i > 0; i--) {
+            if (sizes[i - 1] == value) {
+                return i - 1;
+            }
+        }
+    }
+    return -1;
+}
+}  // namespace
+
+ssize_t find_best_fit_scalar(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up) {
+    ssize_t best = -1;
+    ssize_t increment = bottom_up ? 1 : -1;
+    for (ssize_t i = bottom_up ? 0 : ssize_t(count) - 1; i >= 0 && i < ssize_t(count); i += increment) {
+        if (sizes[i] == alloc_size) {
+            return i;
+        } else if (sizes[i] > alloc_size && (best == -1 || sizes[i] < sizes[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) ssize_t find_best_fit_avx2(
+    const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up) {
+    constexpr size_t lanes = 4;
+    constexpr int64_t no_fit = std::numeric_limits<int64_t>::max();
+    // AVX2 only has signed 64 bit compares. Fine as sizes are below 2^63
+    const __m256i fit_threshold = _mm256_set1_epi64x(int64_t(alloc_size) - 1);
+    const __m256i exact = _mm256_set1_epi64x(int64_t(alloc_size));
+    const __m256i none = _mm256_set1_epi64x(no_fit);
+    __m256i best = none;
+
+    // The elements past the last full vector are scanned one by one. They come first when walking top down
+    const size_t n_vectors = count / lanes;
+    const size_t tail_start = n_vectors * lanes;
+    int64_t tail_min = no_fit;
+    auto scan_tail = [&]() -> ssize_t {
+        for (size_t k = 0; k < count - tail_start; k++) {
+            size_t i = bottom_up ? tail_start + k : count - 1 - k;
+            if (sizes[i] == alloc_size) {
+                return i;
+            } else if (sizes[i] > alloc_size && int64_t(sizes[i]) < tail_min) {
+                tail_min = sizes[i];
+            }
+        }
+        return -1;
+    };
+    if (!bottom_up) {
+        if (ssize_t exact_index = scan_tail(); exact_index != -1) {
+            return exact_index;
+        }
+    }
+
+    for (size_t v = 0; v < n_vectors; v++) {
+        size_t i = (bottom_up ? v : n_vectors - 1 - v) * lanes;
+        __m256i block_sizes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sizes + i));
+        int exact_mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block_sizes, exact)));
+        if (exact_mask != 0) {
+            // Stop at the first exact fit like the scalar version would
+            return i + (bottom_up ? __builtin_ctz(exact_mask) : 31 - __builtin_clz(exact_mask));
+        }
+        __m256i fits = _mm256_cmpgt_epi64(block_sizes, fit_threshold);
+        __m256i candidate = _mm256_blendv_epi8(none, block_sizes, fits);
+        best = _mm256_blendv_epi8(best, candidate, _mm256_cmpgt_epi64(best, candidate));
+    }
+
+    if (bottom_up) {
+        if (ssize_t exact_index = scan_tail(); exact_index != -1) {
+            return exact_index;
+        }
+    }
+    alignas(32) int64_t best_lanes[lanes];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(best_lanes), best);
+    int64_t min_size = tail_min;
+    for (size_t l = 0; l < lanes; l++) {
+        min_size = std::min(min_size, best_lanes[l]);
+    }
+    if (min_size == no_fit) {
+        return -1;
+    }
+    return locate(sizes, count, DeviceAddr(min_size), bottom_up);
+}
+
+__attribute__((target("avx512f"))) ssize_t find_best_fit_avx512(
+    const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up) {
+    constexpr size_t lanes = 8;
+    const __m512i requested = _mm512_set1_epi64(int64_t(alloc_size));
+    __m512i best = _mm512_set1_epi64(-1);  // UINT64_MAX, nothing fits
+
+    const size_t n_vectors = (count + lanes - 1) / lanes;
+    for (size_t v = 0; v < n_vectors; v++) {
+        size_t i = (bottom_up ? v : n_vectors - 1 - v) * lanes;
+        __mmask8 valid = count - i >= lanes ? __mmask8(0xff) : __mmask8((1u << (count - i)) - 1);
+        __m512i block_sizes = _mm512_maskz_loadu_epi64(valid, sizes + i);
+        __mmask8 exact_mask = _mm512_mask_cmpeq_epu64_mask(valid, block_sizes, requested);
+        if (exact_mask != 0) {
+            return i + (bottom_up ? __builtin_ctz(exact_mask) : 31 - __builtin_clz(exact_mask));
+        }
+        __mmask8 fits = _mm512_mask_cmpgt_epu64_mask(valid, block_sizes, requested);
+        best = _mm512_mask_min_epu64(best, fits, best, block_sizes);
+    }
+
+    alignas(64) uint64_t best_lanes[lanes];
+    _mm512_store_si512(best_lanes, best);
+    uint64_t min_size = *std::min_element(best_lanes, best_lanes + lanes);
+    if (min_size == std::numeric_limits<uint64_t>::max()) {
+        return -1;
+    }
+    return locate(sizes, count, DeviceAddr(min_size), bottom_up);
+}
+
+bool cpu_has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+bool cpu_has_avx512() {
+    static const bool supported = __builtin_cpu_supports("avx512f");
+    return supported;
+}
+#else
+bool cpu_has_avx2() { return false; }
+bool cpu_has_avx512() { return false; }
+#endif
+
+ssize_t find_best_fit(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up) {
+#if defined(__x86_64__)
+    if (count >= min_vector_count) {
+        static const auto vector_impl = cpu_has_avx512() ? find_best_fit_avx512
+                                        : cpu_has_avx2() ? find_best_fit_avx2
+                                                         : find_best_fit_scalar;
+        return vector_impl(sizes, count, alloc_size, bottom_up);
+    }
+#endif
+    return find_best_fit_scalar(sizes, count, alloc_size, bottom_up);
+}
+
+}  // namespace simd
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <sys/types.h>
+
+#include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+namespace simd {
+// Best fit search over a contiguous array of free block sizes. Returns the index of the smallest size that is at
+// least alloc_size, or -1 if nothing fits. Ties are broken in the walk direction (lowest index if bottom_up, highest
+// otherwise), which matches a scalar search that stops at the first exact fit. Sizes must be below 2^63
+ssize_t find_best_fit(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up);
+
+// Individual implementations, exposed for testing and benchmarking. The vector versions must only be called if the
+// CPU supports them
+ssize_t find_best_fit_scalar(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up);
+#if defined(__x86_64__)
+ssize_t find_best_fit_avx2(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up);
+ssize_t find_best_fit_avx512(const DeviceAddr* sizes, size_t count, DeviceAddr alloc_size, bool bottom_up);
+#endif
+bool cpu_has_avx2();
+bool cpu_has_avx512();
+
+}  // namespace simd
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
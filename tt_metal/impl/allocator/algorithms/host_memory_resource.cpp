@@ -0,0 +1,87 @@
+#include "tt_metal/impl/allocator/algorithms/host_memory_resource.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+
+#include <sys/mman.h>
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+
+namespace {
+std::byte* map_region(size_t size_bytes) {
+    void* base = mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        TT_THROW("Failed to map {} B of host memory: {}", size_bytes, std::strerror(errno));
+    }
+    return static_cast<std::byte*>(base);
+}
+}  // namespace
+
+HostMemoryResource::HostMemoryResource(size_t size_bytes, size_t alignment, const FreeListOpt::Options& options) :
+    base_(map_region(size_bytes)),
+    size_(size_bytes),
+    alignment_(alignment),
+    owns_region_(true),
+    allocator_(size_bytes, 0, alignment, alignment, options) {}
+
+HostMemoryResource::HostMemoryResource(
+    void* base, size_t size_bytes, size_t alignment, const FreeListOpt::Options& options) :
+    base_(static_cast<std::byte*>(base)),
+    size_(size_bytes),
+    alignment_(alignment),
+    owns_region_(false),
+    allocator_(size_bytes, 0, alignment, alignment, options) {
+    TT_FATAL(
+        reinterpret_cast<uintptr_t>(base) % alignment == 0,
+        "Host region at {} should be {} B aligned",
+        base,
+        alignment);
+}
+
+HostMemoryResource::~HostMemoryResource() {
+    if (owns_region_) {
+        munmap(base_, size_);
+    }
+}
+
+void* HostMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    std::optional<DeviceAddr> offset;
+    if (alignment <= alignment_) {
+        offset = allocator_.allocate(bytes);
+    } else {
+        // Lowest start in a free range whose host address has the requested alignment and leaves room for the
+        // allocation
+        DeviceAddr alloc_size = allocator_.align(std::max<DeviceAddr>(bytes, 1));
+        uintptr_t base_address = reinterpret_cast<uintptr_t>(base_);
+        std::optional<DeviceAddr> start;
+        allocator_.for_each_available_address(alloc_size, [&](DeviceAddr range_start, DeviceAddr range_end) {
+            DeviceAddr aligned = (base_address + range_start + alignment - 1) / alignment * alignment - base_address;
+            if (aligned + alloc_size <= range_end) {
+                start = aligned;
+                return false;
+            }
+            return true;
+        });
+        if (start.has_value()) {
+            offset = allocator_.allocate_at_address(*start, bytes);
+        }
+    }
+    if (!offset.has_value()) {
+        throw std::bad_alloc();
+    }
+    return base_ + *offset;
+}
+
+void HostMemoryResource::do_deallocate(void* p, size_t /*bytes*/, size_t /*alignment*/) {
+    allocator_.deallocate(static_cast<std::byte*>(p) - base_);
+}
+
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+// std::pmr::memory_resource over a host memory region (pinned staging buffers, sysmem, ...) with FreeListOpt managing
+// the placement. FreeListOpt only ever sees offsets into the region, the metadata lives outside of it so the region
+// can be memory the host must not scribble on. Either maps its own anonymous region or manages one it is given.
+// Not thread safe, same as FreeListOpt.
+//
+// Requests aligned to more than the heap alignment are placed by searching the free ranges for an aligned start,
+// which walks the whole block list. Pick the heap alignment so that this is rare
+class HostMemoryResource : public std::pmr::memory_resource {
+public:
+    // Map size_bytes of anonymous memory. Pages are only backed once touched
+    explicit HostMemoryResource(
+        size_t size_bytes, size_t alignment = alignof(std::max_align_t), const FreeListOpt::Options& options = {});
+    // Manage [base, base + size_bytes), which must stay valid for the lifetime of the resource. base must be aligned
+    HostMemoryResource(
+        void* base,
+        size_t size_bytes,
+        size_t alignment = alignof(std::max_align_t),
+        const FreeListOpt::Options& options = {});
+    ~HostMemoryResource() override;
+    HostMemoryResource(const HostMemoryResource&) = delete;
+    HostMemoryResource& operator=(const HostMemoryResource&) = delete;
+
+    void* base() const { return base_; }
+    size_t size() const { return size_; }
+    // Free everything allocated from the resource at once
+    void release() { allocator_.clear(); }
+    Statistics get_statistics() const { return allocator_.get_statistics(); }
+    // The engine, for dumps, watermarks and so on. Addresses in it are offsets into the region
+    const FreeListOpt& allocator() const { return allocator_; }
+    FreeListOpt& allocator() { return allocator_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::byte* base_;
+    size_t size_;
+    size_t alignment_;
+    bool owns_region_;
+    FreeListOpt allocator_;
+};
+
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
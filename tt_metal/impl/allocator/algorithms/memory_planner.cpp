@@ -0,0 +1,165 @@
+#include "tt_metal/impl/allocator/algorithms/memory_planner.hpp"
+#include "tt_metal/impl/allocator/algorithms/free_list_opt.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+
+namespace {
+DeviceAddr align_up(DeviceAddr value, DeviceAddr alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+bool lifetimes_overlap(const PlannedBuffer& a, const PlannedBuffer& b) {
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+// Place buffers one by one in the given order. Each buffer goes into the tightest gap between already placed buffers
+// that are live at the same time, or after all of them if no gap fits
+std::vector<DeviceAddr> place_in_order(const std::vector<PlannedBuffer>& buffers, const std::vector<size_t>& order) {
+    std::vector<DeviceAddr> offsets(buffers.size(), 0);
+    std::vector<size_t> placed;
+    placed.reserve(buffers.size());
+    std::vector<std::pair<DeviceAddr, DeviceAddr>> occupied;
+
+    for (size_t idx : order) {
+        const PlannedBuffer& buffer = buffers[idx];
+        const DeviceAddr alignment = std::max(buffer.alignment, DeviceAddr{1});
+        occupied.clear();
+        for (size_t other : placed) {
+            if (lifetimes_overlap(buffer, buffers[other])) {
+                occupied.emplace_back(offsets[other], offsets[other] + buffers[other].size);
+            }
+        }
+        std::sort(occupied.begin(), occupied.end());
+
+        DeviceAddr cursor = 0;
+        DeviceAddr best_gap = std::numeric_limits<DeviceAddr>::max();
+        std::optional<DeviceAddr> best_offset;
+        for (const auto& [start, end] : occupied) {
+            DeviceAddr candidate = align_up(cursor, alignment);
+            if (start > candidate && start - candidate >= buffer.size && start - candidate < best_gap) {
+                best_gap = start - candidate;
+                best_offset = candidate;
+            }
+            cursor = std::max(cursor, end);
+        }
+        offsets[idx] = best_offset.value_or(align_up(cursor, alignment));
+        placed.push_back(idx);
+    }
+    return offsets;
+}
+
+DeviceAddr plan_footprint(const std::vector<PlannedBuffer>& buffers, const std::vector<DeviceAddr>& offsets) {
+    DeviceAddr peak = 0;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        peak = std::max(peak, offsets[i] + buffers[i].size);
+    }
+    return peak;
+}
+
+DeviceAddr live_size_lower_bound(const std::vector<PlannedBuffer>& buffers) {
+    // (time, delta) events. Ends are processed at last_use + 1 so buffers ending and starting at the same step overlap
+    std::vector<std::pair<size_t, int64_t>> events;
+    events.reserve(buffers.size() * 2);
+    for (const auto& buffer : buffers) {
+        events.emplace_back(buffer.first_use, int64_t(buffer.size));
+        events.emplace_back(buffer.last_use + 1, -int64_t(buffer.size));
+    }
+    std::sort(events.begin(), events.end());
+    int64_t live = 0;
+    int64_t peak = 0;
+    for (const auto& [time, delta] : events) {
+        live += delta;
+        peak = std::max(peak, live);
+    }
+    return DeviceAddr(peak);
+}
+}  // namespace
+
+MemoryPlan plan_memory(const std::vector<PlannedBuffer>& buffers, PlanningHeuristic heuristic) {
+    for (const auto& buffer : buffers) {
+        TT_FATAL(
+            buffer.first_use <= buffer.last_use,
+            "Buffer first use {} is after its last use {}",
+            buffer.first_use,
+            buffer.last_use);
+    }
+
+    MemoryPlan plan;
+    plan.lower_bound_bytes = live_size_lower_bound(buffers);
+    for (const auto& buffer : buffers) {
+        plan.alignment = std::max(plan.alignment, buffer.alignment);
+    }
+
+    std::vector<size_t> order(buffers.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto try_order = [&](auto compare) {
+        std::stable_sort(order.begin(), order.end(), compare);
+        auto offsets = place_in_order(buffers, order);
+        DeviceAddr peak = plan_footprint(buffers, offsets);
+        if (plan.offsets.empty() || peak < plan.peak_bytes) {
+            plan.offsets = std::move(offsets);
+            plan.peak_bytes = peak;
+        }
+    };
+
+    if (heuristic == PlanningHeuristic::GREEDY_BY_SIZE || heuristic == PlanningHeuristic::BEST) {
+        try_order([&](size_t a, size_t b) {
+            if (buffers[a].size != buffers[b].size) {
+                return buffers[a].size > buffers[b].size;
+            }
+            return buffers[a].first_use < buffers[b].first_use;
+        });
+    }
+    if (heuristic == PlanningHeuristic::INTERVAL_COLORING || heuristic == PlanningHeuristic::BEST) {
+        try_order([&](size_t a, size_t b) {
+            if (buffers[a].first_use != buffers[b].first_use) {
+                return buffers[a].first_use < buffers[b].first_use;
+            }
+            return buffers[a].size > buffers[b].size;
+        });
+    }
+    return plan;
+}
+
+std::optional<CommittedPlan> commit_memory_plan(
+    FreeListOpt& allocator, const MemoryPlan& plan, std::optional<DeviceAddr> base_address) {
+    std::optional<DeviceAddr> arena_address;
+    DeviceAddr arena_start = 0;
+    if (base_address.has_value()) {
+        TT_FATAL(
+            *base_address % plan.alignment == 0,
+            "Base address {} should be {} B aligned for this plan",
+            *base_address,
+            plan.alignment);
+        arena_address = allocator.allocate_at_address(*base_address, plan.peak_bytes);
+        arena_start = *base_address;
+    } else {
+        arena_address = allocator.allocate(plan.peak_bytes);
+        // The allocator only guarantees its own alignment. Pad the arena if the plan needs more
+        if (arena_address.has_value() && *arena_address % plan.alignment != 0) {
+            allocator.deallocate(*arena_address);
+            arena_address = allocator.allocate(plan.peak_bytes + plan.alignment - 1);
+        }
+        if (arena_address.has_value()) {
+            arena_start = align_up(*arena_address, plan.alignment);
+        }
+    }
+    if (!arena_address.has_value()) {
+        return std::nullopt;
+    }
+
+    CommittedPlan committed{.arena_address = *arena_address, .addresses = {}};
+    committed.addresses.reserve(plan.offsets.size());
+    for (DeviceAddr offset : plan.offsets) {
+        committed.addresses.push_back(arena_start + offset);
+    }
+    return committed;
+}
+
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt
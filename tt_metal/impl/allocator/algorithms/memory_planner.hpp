@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tt_metal/impl/allocator/algorithms/allocator_algorithm.hpp"
+
+namespace tt {
+namespace tt_metal {
+namespace allocator {
+class FreeListOpt;
+
+// Offline memory planner for graphs where every buffer's size and lifetime is known ahead of time (traced/compiled
+// programs). Instead of allocating online and paying for the search and the fragmentation it causes, all buffers are
+// packed into a single arena up front. Buffers whose lifetimes do not overlap are allowed to share memory.
+struct PlannedBuffer {
+    DeviceAddr size;
+    size_t first_use;          // first step the buffer is live at (inclusive)
+    size_t last_use;           // last step the buffer is live at (inclusive)
+    DeviceAddr alignment = 1;  // required alignment of the offset in the arena
+};
+
+enum class PlanningHeuristic {
+    // Place the largest buffers first, each at the tightest gap left between buffers with overlapping lifetimes
+    // (the greedy by size strategy TFLite uses). Usually the best for graphs with a few large tensors
+    GREEDY_BY_SIZE = 0,
+    // Walk buffers in order of first use like a linear scan register allocator, best fitting each into the gaps left
+    // by buffers that are live at the same time. Usually the best for long chains of similarly sized buffers
+    INTERVAL_COLORING = 1,
+    // Run all heuristics and keep the plan with the smallest footprint
+    BEST = 2,
+};
+
+struct MemoryPlan {
+    std::vector<DeviceAddr> offsets;   // offset of each buffer in the arena, same order as the input
+    DeviceAddr peak_bytes = 0;         // size of the arena
+    DeviceAddr lower_bound_bytes = 0;  // largest sum of sizes of simultaneously live buffers. No plan can beat this
+    DeviceAddr alignment = 1;          // the arena must start at an address with this alignment
+};
+
+MemoryPlan plan_memory(const std::vector<PlannedBuffer>& buffers, PlanningHeuristic heuristic = PlanningHeuristic::BEST);
+
+struct CommittedPlan {
+    DeviceAddr arena_address;           // address of the reserved arena, pass this to deallocate to release the plan
+    std::vector<DeviceAddr> addresses;  // absolute address of each buffer, same order as the input
+};
+
+// Reserves the arena for a plan in the allocator with a single allocation and resolves the absolute address of every
+// buffer. If base_address is given the arena is placed there with allocate_at_address, else anywhere it fits.
+// Returns std::nullopt if the arena does not fit
+std::optional<CommittedPlan> commit_memory_plan(
+    FreeListOpt& allocator, const MemoryPlan& plan, std::optional<DeviceAddr> base_address = std::nullopt);
+
+}  // namespace allocator
+}  // namespace tt_metal
+}  // namespace tt